@@ -4,15 +4,63 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <pthread.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// Linux에서는 실행 루프의 hardware counter를 perf_event로 측정할 수 있음
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
+// x86에서는 batch 실행의 R/I type 연산을 AVX2로 처리 (-DNO_AVX2로 끌 수 있음). 실행 중 CPU가 지원하는지 확인함
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(NO_AVX2)
+#include <immintrin.h>
+#define HAS_AVX2_KERNEL
+#endif
 
 #define MAX_LINE_LENGTH 50 // 사용자에게서 입력받는 파일이름 크기 최댓값
 
+#define MAX_SOURCE_LINE_LENGTH 256 // 입력 프로그램 한 줄의 최대 길이
+
 #define STARTING_PC 1000 // 시작 PC 주소
 
 #define EXIT_CODE 0xFFFFFFFF // 종료 기계어 명령어
 
 #define MAX_LINE_COUNT 5000 // 가능한 레이블 개수 최댓값
 
+#define MEMORY_SIZE 65536 // 바이트 단위 가상 메모리 크기
+
+#define DATA_SEGMENT_ADDRESS 0x2000 // .data 영역의 시작 메모리 주소
+
+#define MAX_DATA_WORD_COUNT ((MEMORY_SIZE - DATA_SEGMENT_ADDRESS) / 4) // .data 영역에 넣을 수 있는 word 개수 최댓값
+
+#define MAX_HART_COUNT 64 // 동시에 실행할 수 있는 hart 개수 최댓값
+
+#define MAX_LANE_COUNT 256 // batch 실행에서 초기 상태(lane) 개수 최댓값
+
+#define HALTED_LANE_PC (-1) // 실행이 끝난 lane의 PC
+
+#define MAX_DIAGNOSTICS_LENGTH 4096 // 한 번의 실행에서 모아 두는 오류 메시지 길이 최댓값
+
+#define TOOL_VERSION "1.0" // 출력 형식이 바뀌면 올려서 이전 캐시를 쓰지 않도록 함
+
+#define CACHE_DIRECTORY ".rvcache" // 파일명.o, 파일명.trace를 저장해 두는 캐시 디렉터리
+
+#define MAX_WORKER_COUNT 64 // daemon 모드에서 요청을 처리하는 worker process 개수 최댓값
+
+#define MAX_SOURCE_SIZE (MAX_LINE_COUNT * MAX_SOURCE_LINE_LENGTH) // daemon 모드에서 받을 수 있는 소스 크기 최댓값
+
+#define DEFAULT_DAEMON_MAX_STEPS 10000000 // daemon 모드에서 요청 하나가 실행할 수 있는 명령어 개수 기본값
+
 typedef struct {
     char name[10];
     int opcode;
@@ -39,53 +87,227 @@ typedef struct {
     int funct3;
 } SB_Instruction;
 
+typedef struct {
+    char name[10];
+    int opcode;
+} U_Instruction;
+
 typedef struct {
     char name[10];
     int opcode;
 } UJ_Instruction;
 
+typedef struct {
+    char name[10];
+    int operand_count;
+    char expansion[32]; // 확장될 실제 명령어. %0, %1, %2는 operand로 치환
+} Pseudo_Instruction;
+
 typedef struct {
     char name[MAX_LINE_LENGTH];
-    int pc_address;
-    int instruction_index;
+    int pc_address; // .data 레이블은 메모리 주소
+    int instruction_index; // .data 레이블은 -1
 } Label;
 
-Label labels[100]; // 레이블 저장 배열
+typedef enum {
+    R_TYPE,
+    I_TYPE,
+    S_TYPE,
+    SB_TYPE,
+    U_TYPE,
+    UJ_TYPE,
+    EXIT_TYPE
+} Instruction_Type;
+
+// record_label에서 레이블 주소로 imm을 채우는 방식
+typedef enum {
+    NO_RELOCATION,
+    BRANCH_OFFSET, // SB, UJ 타입의 PC 상대 offset
+    PCREL_HI, // la 확장의 AUIPC: offset의 상위 20비트
+    PCREL_LO // la 확장의 ADDI: 바로 앞 AUIPC 기준 offset의 하위 12비트
+} Relocation_Type;
+
+// 한 번 파싱(decode)된 명령어. 기계어 변환과 실행은 이 배열만 사용함
+typedef struct {
+    Instruction_Type type;
+
+    union {
+        const R_Instruction *r;
+        const I_Instruction *i;
+        const S_Instruction *s;
+        const SB_Instruction *sb;
+        const U_Instruction *u;
+        const UJ_Instruction *uj;
+    } instr;
+
+    int rd;
+    int rs1;
+    int rs2;
+    int imm; // relocation이 있으면 record_label 이후에 채워짐
+    Relocation_Type relocation;
+    char label[MAX_LINE_LENGTH]; // relocation 대상 레이블
+    int pc;
+    int original_pc; // 최적화 전 PC (최적화된 프로그램의 trace에 함께 기록)
+} Instruction;
+
+typedef enum {
+    TAKEN_EDGE, // 분기 성공
+    FALL_THROUGH_EDGE, // 다음 명령어로 진행 (분기 실패 포함)
+    JUMP_EDGE, // JAL x0, label
+    CALL_EDGE, // JAL rd != x0 의 호출 대상
+    RETURN_EDGE // 호출 다음 블록 (JALR로 돌아오는 지점)
+} Edge_Type;
+
+typedef struct {
+    int start; // 블록의 첫 명령어 index
+    int end; // 블록의 마지막 명령어 다음 index
+    int successors[2];
+    Edge_Type successor_types[2];
+    int successor_count;
+    bool has_indirect_successor; // JALR로 끝나서 다음 블록을 정적으로 알 수 없음
+    bool is_indirect_target; // JALR로 도착할 수 있는 블록 (호출 다음 블록, la로 주소를 얻은 레이블)
+} Basic_Block;
+
+typedef enum {
+    UNDEFINED_VALUE, // 아직 값이 도달하지 않음
+    CONSTANT_VALUE,
+    VARIABLE_VALUE // 실행 경로에 따라 값이 달라짐
+} Value_Kind;
+
+typedef struct {
+    Value_Kind kind;
+    int value;
+} Register_Value;
+
+typedef enum {
+    NO_OPTIMIZATION,
+    OPTIMIZE_REPORT, // 최적화 보고서만 생성
+    OPTIMIZE_RUN // 보고서와 함께 최적화된 프로그램을 실행
+} Optimize_Mode;
+
+typedef enum {
+    ROUND_ROBIN_SCHEDULE, // 한 스레드에서 hart마다 명령어 하나씩 번갈아 실행 (항상 같은 interleaving)
+    THREAD_SCHEDULE // hart마다 host 스레드 하나 (interleaving은 실행마다 다를 수 있음)
+} Schedule_Mode;
+
+typedef struct {
+    const Instruction *program; // 이 hart가 실행하는 decode된 프로그램
+    int instruction_count;
+    int registers[32];
+    int pc;
+    FILE *trace;
+    bool halted;
+} Hart;
+
+Label labels[MAX_LINE_COUNT]; // 레이블 저장 배열
+int label_count = 0;
+
+Instruction program[MAX_LINE_COUNT]; // decode된 명령어 저장 배열
+int instruction_count = 0;
+
+int data_words[MAX_DATA_WORD_COUNT]; // .word로 정의된 초기 메모리 값
+int data_word_count = 0;
+int data_segment_address = DATA_SEGMENT_ADDRESS; // 현재 프로그램의 .data 시작 주소 (multi-hart에서는 파일마다 다름)
 
 R_Instruction r_instructions[] = {
     {"ADD", 0x33, 0x0, 0x00}, // Addition
     {"SUB", 0x33, 0x0, 0x20}, // Subtraction
     {"SLL", 0x33, 0x1, 0x00}, // Shift Left Logical
+    {"SLT", 0x33, 0x2, 0x00}, // Set Less Than
+    {"SLTU", 0x33, 0x3, 0x00}, // Set Less Than Unsigned
     {"XOR", 0x33, 0x4, 0x00}, // XOR (Exclusive OR)
     {"SRL", 0x33, 0x5, 0x00}, // Shift Right Logical
     {"SRA", 0x33, 0x5, 0x20}, // Shift Right Arithmetic
     {"OR", 0x33, 0x6, 0x00}, // OR (Logical OR)
-    {"AND", 0x33, 0x7, 0x00} // AND (Logical AND)
+    {"AND", 0x33, 0x7, 0x00}, // AND (Logical AND)
+    {"MUL", 0x33, 0x0, 0x01}, // Multiply (RV32M)
+    {"MULH", 0x33, 0x1, 0x01}, // Multiply High Signed x Signed (RV32M)
+    {"MULHSU", 0x33, 0x2, 0x01}, // Multiply High Signed x Unsigned (RV32M)
+    {"MULHU", 0x33, 0x3, 0x01}, // Multiply High Unsigned x Unsigned (RV32M)
+    {"DIV", 0x33, 0x4, 0x01}, // Divide Signed (RV32M)
+    {"DIVU", 0x33, 0x5, 0x01}, // Divide Unsigned (RV32M)
+    {"REM", 0x33, 0x6, 0x01}, // Remainder Signed (RV32M)
+    {"REMU", 0x33, 0x7, 0x01} // Remainder Unsigned (RV32M)
 };
 
 I_Instruction i_instructions[] = {
     {"ADDI", 0x13, 0x0, 0}, // Add Immediate
+    {"SLTI", 0x13, 0x2, 0}, // Set Less Than Immediate
+    {"SLTIU", 0x13, 0x3, 0}, // Set Less Than Immediate Unsigned
     {"XORI", 0x13, 0x4, 0}, // XOR Immediate
     {"ORI", 0x13, 0x6, 0}, // OR Immediate
     {"ANDI", 0x13, 0x7, 0}, // AND Immediate
     {"SLLI", 0x13, 0x1, 0x00}, // Shift Left Logical Immediate (funct7 = 0x00)
     {"SRLI", 0x13, 0x5, 0x00}, // Shift Right Logical Immediate (funct7 = 0x00)
     {"SRAI", 0x13, 0x5, 0x20}, // Shift Right Arithmetic Immediate (funct7 = 0x20)
+    {"LB", 0x03, 0x0, 0}, // Load Byte
+    {"LH", 0x03, 0x1, 0}, // Load Halfword
     {"LW", 0x03, 0x2, 0}, // Load Word
+    {"LBU", 0x03, 0x4, 0}, // Load Byte Unsigned
+    {"LHU", 0x03, 0x5, 0}, // Load Halfword Unsigned
     {"JALR", 0x67, 0x0, 0} // Jump And Link Register
 };
 
-S_Instruction s_instructions = {"SW", 0x23, 0x2}; // Store Word
+S_Instruction s_instructions[] = {
+    {"SB", 0x23, 0x0}, // Store Byte
+    {"SH", 0x23, 0x1}, // Store Halfword
+    {"SW", 0x23, 0x2} // Store Word
+};
 
 SB_Instruction sb_instructions[] = {
     {"BEQ", 0x63, 0x0}, // Branch if Equal
     {"BNE", 0x63, 0x1}, // Branch if Not Equal
     {"BLT", 0x63, 0x4}, // Branch if Less Than
-    {"BGE", 0x63, 0x5} // Branch if Greater or Equal
+    {"BGE", 0x63, 0x5}, // Branch if Greater or Equal
+    {"BLTU", 0x63, 0x6}, // Branch if Less Than Unsigned
+    {"BGEU", 0x63, 0x7} // Branch if Greater or Equal Unsigned
+};
+
+U_Instruction u_instructions[] = {
+    {"LUI", 0x37}, // Load Upper Immediate
+    {"AUIPC", 0x17} // Add Upper Immediate to PC
 };
 
 UJ_Instruction uj_instructions = {"JAL", 0x6F}; // Jump and Link
 
+// li, la는 값에 따라 확장이 달라지므로 expand_pseudo_instruction에서 따로 처리
+// call, tail은 프로그램 크기가 JAL 범위(±1MB)를 넘지 않으므로 AUIPC + JALR 대신 JAL 하나로 확장
+Pseudo_Instruction pseudo_instructions[] = {
+    {"NOP", 0, "ADDI x0, x0, 0"}, // No Operation
+    {"MV", 2, "ADDI %0, %1, 0"}, // Move
+    {"NOT", 2, "XORI %0, %1, -1"}, // One's Complement
+    {"NEG", 2, "SUB %0, x0, %1"}, // Two's Complement
+    {"SEQZ", 2, "SLTIU %0, %1, 1"}, // Set if Equal to Zero
+    {"SNEZ", 2, "SLTU %0, x0, %1"}, // Set if Not Equal to Zero
+    {"SLTZ", 2, "SLT %0, %1, x0"}, // Set if Less Than Zero
+    {"SGTZ", 2, "SLT %0, x0, %1"}, // Set if Greater Than Zero
+    {"BEQZ", 2, "BEQ %0, x0, %1"}, // Branch if Equal to Zero
+    {"BNEZ", 2, "BNE %0, x0, %1"}, // Branch if Not Equal to Zero
+    {"BLEZ", 2, "BGE x0, %0, %1"}, // Branch if Less or Equal to Zero
+    {"BGEZ", 2, "BGE %0, x0, %1"}, // Branch if Greater or Equal to Zero
+    {"BLTZ", 2, "BLT %0, x0, %1"}, // Branch if Less Than Zero
+    {"BGTZ", 2, "BLT x0, %0, %1"}, // Branch if Greater Than Zero
+    {"BGT", 3, "BLT %1, %0, %2"}, // Branch if Greater Than
+    {"BLE", 3, "BGE %1, %0, %2"}, // Branch if Less or Equal
+    {"BGTU", 3, "BLTU %1, %0, %2"}, // Branch if Greater Than Unsigned
+    {"BLEU", 3, "BGEU %1, %0, %2"}, // Branch if Less or Equal Unsigned
+    {"J", 1, "JAL x0, %0"}, // Jump
+    {"JAL", 1, "JAL x1, %0"}, // Jump and Link to ra
+    {"JR", 1, "JALR x0, 0(%0)"}, // Jump Register
+    {"JALR", 1, "JALR x1, 0(%0)"}, // Jump and Link Register to ra
+    {"RET", 0, "JALR x0, 0(x1)"}, // Return from procedure
+    {"CALL", 1, "JAL x1, %0"}, // Call procedure
+    {"TAIL", 1, "JAL x0, %0"} // Tail call procedure
+};
+
+// x0 ~ x31의 ABI 이름 (x8은 fp로도 사용 가능)
+const char *abi_register_names[32] = {
+    "zero", "ra", "sp", "gp", "tp", "t0", "t1", "t2",
+    "s0", "s1", "a0", "a1", "a2", "a3", "a4", "a5",
+    "a6", "a7", "s2", "s3", "s4", "s5", "s6", "s7",
+    "s8", "s9", "s10", "s11", "t3", "t4", "t5", "t6"
+};
+
 // =====================================================================================================================
 //
 // Registers & Memory
@@ -93,7 +315,6 @@ UJ_Instruction uj_instructions = {"JAL", 0x6F}; // Jump and Link
 // =====================================================================================================================
 
 int registers[32]; // virtual register for execution
-int return_pc = 0;
 
 void initialize_registers() {
     // x0는 항상 0
@@ -108,7 +329,120 @@ void initialize_registers() {
     }
 }
 
-int memory[1024] = {0,}; // virtual memory for execution
+// 실행 중 출력한 오류 메시지를 모아 두어 캐시에 함께 저장하고 daemon 응답으로 보냄
+char runtime_diagnostics[MAX_DIAGNOSTICS_LENGTH];
+size_t runtime_diagnostics_length = 0;
+bool runtime_diagnostics_truncated = false; // 다 모으지 못했으면 캐시에 저장하지 않음
+pthread_mutex_t runtime_diagnostics_lock = PTHREAD_MUTEX_INITIALIZER; // hart가 host 스레드에서 동시에 호출할 수 있음
+
+void clear_runtime_diagnostics(void) {
+    runtime_diagnostics_length = 0;
+    runtime_diagnostics_truncated = false;
+    runtime_diagnostics[0] = '\0';
+}
+
+// message를 출력하고 runtime_diagnostics 뒤에 한 줄로 추가
+void report_runtime_error(const char *message) {
+    const size_t length = strlen(message);
+
+    pthread_mutex_lock(&runtime_diagnostics_lock);
+
+    printf("%s\n", message);
+
+    if (runtime_diagnostics_length + length + 2 > sizeof(runtime_diagnostics)) {
+        runtime_diagnostics_truncated = true;
+    } else {
+        memcpy(runtime_diagnostics + runtime_diagnostics_length, message, length);
+        runtime_diagnostics_length += length;
+        runtime_diagnostics[runtime_diagnostics_length++] = '\n';
+        runtime_diagnostics[runtime_diagnostics_length] = '\0';
+    }
+
+    pthread_mutex_unlock(&runtime_diagnostics_lock);
+}
+
+uint8_t memory[MEMORY_SIZE] __attribute__((aligned(4))) = {0,}; // virtual byte-addressable memory for execution
+uint8_t *execution_memory = memory; // load/store가 접근하는 메모리. batch 실행에서는 lane마다 따로 둔 메모리를 가리킴
+
+void initialize_memory() {
+    memset(memory, 0, sizeof(memory));
+}
+
+// 메모리는 little endian이므로 big endian host에서는 halfword/word를 읽고 쓸 때 바이트 순서를 뒤집음
+uint32_t from_little_endian32(const uint32_t value) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return __builtin_bswap32(value);
+#else
+    return value;
+#endif
+}
+
+uint16_t from_little_endian16(const uint16_t value) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    return __builtin_bswap16(value);
+#else
+    return value;
+#endif
+}
+
+// address부터 size 바이트를 little endian으로 읽음. 범위를 벗어나면 0을 반환
+int load_memory(const int address, const int size, const bool is_unsigned, int *value) {
+    if (address < 0 || address > MEMORY_SIZE - size) {
+        report_runtime_error("Memory access error: address out of bounds");
+        return 0;
+    }
+
+    // 여러 hart가 host 스레드에서 동시에 접근할 수 있으므로 atomic으로 읽음
+    // 정렬된 halfword/word는 한 번에 읽어 다른 hart의 store와 섞인 값이 보이지 않게 함
+    uint32_t word = 0;
+    if (size == 4 && address % 4 == 0) {
+        word = from_little_endian32(__atomic_load_n((uint32_t *) &execution_memory[address], __ATOMIC_ACQUIRE));
+    } else if (size == 2 && address % 2 == 0) {
+        word = from_little_endian16(__atomic_load_n((uint16_t *) &execution_memory[address], __ATOMIC_ACQUIRE));
+    } else {
+        for (int i = 0; i < size; i++) {
+            word |= (uint32_t) __atomic_load_n(&execution_memory[address + i], __ATOMIC_ACQUIRE) << (8 * i);
+        }
+    }
+
+    // LB, LH는 부호 확장, LBU, LHU는 0 확장
+    if (!is_unsigned && size < 4) {
+        const int shift = 32 - 8 * size;
+        *value = (int32_t) (word << shift) >> shift;
+    } else {
+        *value = (int) word;
+    }
+
+    return 1;
+}
+
+// address부터 value의 하위 size 바이트를 little endian으로 씀. 범위를 벗어나면 0을 반환
+int store_memory(const int address, const int size, const int value) {
+    if (address < 0 || address > MEMORY_SIZE - size) {
+        report_runtime_error("Memory access error: address out of bounds");
+        return 0;
+    }
+
+    // load_memory()와 마찬가지로 정렬된 halfword/word는 한 번에 씀
+    if (size == 4 && address % 4 == 0) {
+        __atomic_store_n((uint32_t *) &execution_memory[address], from_little_endian32((uint32_t) value), __ATOMIC_RELEASE);
+    } else if (size == 2 && address % 2 == 0) {
+        __atomic_store_n((uint16_t *) &execution_memory[address], from_little_endian16((uint16_t) value), __ATOMIC_RELEASE);
+    } else {
+        for (int i = 0; i < size; i++) {
+            __atomic_store_n(&execution_memory[address + i], (uint8_t) ((uint32_t) value >> (8 * i)), __ATOMIC_RELEASE);
+        }
+    }
+
+    return 1;
+}
+
+// .word로 정의된 값을 data_segment_address부터 메모리에 적재
+void load_data_segment() {
+    for (int i = 0; i < data_word_count; i++) {
+        store_memory(data_segment_address + i * 4, 4, data_words[i]);
+    }
+}
 
 // =====================================================================================================================
 //
@@ -135,7 +469,12 @@ I_Instruction *find_i_instruction(const char *name) {
 }
 
 S_Instruction *find_s_instruction(const char *name) {
-    return &s_instructions;
+    for (int i = 0; i < sizeof(s_instructions) / sizeof(S_Instruction); i++) {
+        if (strcasecmp(name, s_instructions[i].name) == 0) {
+            return &s_instructions[i];
+        }
+    }
+    return NULL;
 }
 
 SB_Instruction *find_sb_instruction(const char *name) {
@@ -147,8 +486,40 @@ SB_Instruction *find_sb_instruction(const char *name) {
     return NULL;
 }
 
+U_Instruction *find_u_instruction(const char *name) {
+    for (int i = 0; i < sizeof(u_instructions) / sizeof(U_Instruction); i++) {
+        if (strcasecmp(name, u_instructions[i].name) == 0) {
+            return &u_instructions[i];
+        }
+    }
+    return NULL;
+}
+
 UJ_Instruction *find_uj_instruction(const char *name) {
-    return &uj_instructions;
+    if (strcasecmp(name, uj_instructions.name) == 0) {
+        return &uj_instructions;
+    }
+    return NULL;
+}
+
+// 같은 이름이라도 operand 개수가 다르면 실제 명령어 (JAL rd, label / JAL label)
+Pseudo_Instruction *find_pseudo_instruction(const char *name, const int operand_count) {
+    for (int i = 0; i < sizeof(pseudo_instructions) / sizeof(Pseudo_Instruction); i++) {
+        if (strcasecmp(name, pseudo_instructions[i].name) == 0 &&
+            pseudo_instructions[i].operand_count == operand_count) {
+            return &pseudo_instructions[i];
+        }
+    }
+    return NULL;
+}
+
+Label *find_label(const char *name) {
+    for (int i = 0; i < label_count; i++) {
+        if (strcasecmp(labels[i].name, name) == 0) {
+            return &labels[i];
+        }
+    }
+    return NULL;
 }
 
 // =====================================================================================================================
@@ -167,7 +538,7 @@ int encode_r_type(const int funct7, const int rs2, const int rs1,
 // Encode I-type instruction
 int encode_i_type(const int imm, const int rs1, const int funct3,
                   const int rd, const int opcode) {
-    return (imm << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode;
+    return ((imm & 0xFFF) << 20) | (rs1 << 15) | (funct3 << 12) | (rd << 7) | opcode;
 }
 
 // Encode S-type instruction
@@ -184,6 +555,11 @@ int encode_sb_type(const int imm2, const int rs2, const int rs1,
     return (imm2 << 25) | (rs2 << 20) | (rs1 << 15) | (funct3 << 12) | (imm1 << 7) | opcode;
 }
 
+// Encode U-type instruction
+int encode_u_type(const int imm, const int rd, const int opcode) {
+    return ((imm & 0xFFFFF) << 12) | (rd << 7) | opcode;
+}
+
 // Encode UJ-type instruction
 int encode_uj_type(const int imm, const int rd, const int opcode) {
     return (imm << 12) | (rd << 7) | opcode;
@@ -252,603 +628,3087 @@ int parse_imm_for_uj_type_inst(int imm) {
     return result;
 }
 
+bool annotate_original_pc = false; // true이면 trace에 최적화 전 PC를 함께 기록
+
 void fprintf_pc_into_trace_file(FILE *trace, const int *pc) {
+    if (annotate_original_pc) {
+        fprintf(trace, "%u %u\n", *pc, program[(*pc - STARTING_PC) / 4].original_pc);
+        return;
+    }
     fprintf(trace, "%u\n", *pc);
 }
 
+// "test1.s" -> "test1.o" 처럼 마지막 확장자를 바꾼 파일 이름을 만듦
+void make_output_filename(const char *filename, const char *extension, char *output, const size_t size) {
+    const char *slash_ptr = strrchr(filename, '/');
+    const char *dot_ptr = strrchr(filename, '.');
+    size_t base_len = strlen(filename);
+
+    if (dot_ptr != NULL && (slash_ptr == NULL || dot_ptr > slash_ptr)) {
+        base_len = dot_ptr - filename;
+    }
+
+    snprintf(output, size, "%.*s%s", (int) base_len, filename, extension);
+}
+
+// 캐시에서 hardlink로 가져온 파일일 수 있으므로 기존 파일을 지우고 새로 만듦 (캐시 내용이 덮어써지지 않도록)
+FILE *create_output_file(const char *path) {
+    remove(path);
+    return fopen(path, "w");
+}
+
 // =====================================================================================================================
 //
-// 각 타입에 맞게 동작을 구현한 코드
+// 어셈블리 코드를 파싱하는 코드
 //
 // =====================================================================================================================
 
-// Execution functions for R type instruction
-void execute_r_type(const R_Instruction *instr, const int rd, const int rs1, const int rs2, FILE *trace, int *pc_ptr,
-                    int *pc_location_ptr) {
-    switch (instr->funct3) {
-        // Case for ADD and SUB
-        case 0x0:
-            // Case for ADD
-            if (instr->funct7 == 0x0) {
-                registers[rd] = registers[rs1] + registers[rs2];
-            }
+// 문자열 앞뒤의 공백을 제거하고 시작 위치를 반환
+char *trim(char *text) {
+    while (isspace((unsigned char) *text)) text++;
 
-            // Case for SUB
-            else if (instr->funct7 == 0x20) {
-                registers[rd] = registers[rs1] - registers[rs2];
-            }
+    char *end = text + strlen(text);
+    while (end > text && isspace((unsigned char) end[-1])) end--;
+    *end = '\0';
 
-            break;
+    return text;
+}
 
-        // Case for SLL
-        case 0x1:
-            registers[rd] = registers[rs1] << registers[rs2];
-            break;
+// x0 ~ x31 또는 ABI 이름(zero, ra, sp, t0, a0, s0, fp ...)을 register 번호로 변환 (대소문자 구분 없음)
+int parse_register(const char *token, int *reg) {
+    for (int i = 0; i < 32; i++) {
+        if (strcasecmp(token, abi_register_names[i]) == 0) {
+            *reg = i;
+            return 1;
+        }
+    }
 
-        // Case for XOR
-        case 0x4:
-            registers[rd] = registers[rs1] ^ registers[rs2];
-            break;
+    if (strcasecmp(token, "fp") == 0) {
+        *reg = 8;
+        return 1;
+    }
 
-        // Case for SRL & SRA
-        case 0x5: {
-            int shamt = registers[rs2] & 0x1F; // Extract shift amount (lower 5 bits)
+    if (tolower((unsigned char) token[0]) != 'x' || !isdigit((unsigned char) token[1])) {
+        return 0;
+    }
 
-            if (instr->funct7 == 0x00) {
-                // SRL (Shift Right Logical)
-                registers[rd] = (uint32_t) registers[rs1] >> shamt; // Logical shift
-            } else if (instr->funct7 == 0x20) {
-                // SRA (Shift Right Arithmetic)
-                registers[rd] = registers[rs1] >> shamt; // Arithmetic shift
-            }
+    char *end_ptr = NULL;
+    const long number = strtol(token + 1, &end_ptr, 10);
+    if (*end_ptr != '\0' || number < 0 || number > 31) {
+        return 0;
+    }
 
-            break;
-        }
+    *reg = (int) number;
+    return 1;
+}
 
-        // Case for OR
-        case 0x6:
-            registers[rd] = registers[rs1] | registers[rs2];
+// 10진수 또는 0x로 시작하는 16진수 immediate를 [min, max] 범위 안에서 변환
+int parse_immediate(const char *token, const long min, const long max, int *imm) {
+    const char *digits = token;
+    if (*digits == '-' || *digits == '+') digits++;
 
-        // Case for AND
-        case 0x7:
-            registers[rd] = registers[rs1] & registers[rs2];
-        default:
-            break;
+    const int base = (digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) ? 16 : 10;
+    if (!isxdigit((unsigned char) digits[base == 16 ? 2 : 0])) {
+        return 0;
     }
 
-    *pc_location_ptr += 1;
-    fprintf_pc_into_trace_file(trace, pc_ptr);
-    *pc_ptr += 4;
+    char *end_ptr = NULL;
+    const long value = strtol(token, &end_ptr, base);
+    if (*end_ptr != '\0' || value < min || value > max) {
+        return 0;
+    }
+
+    *imm = (int) value;
+    return 1;
 }
 
-// Execution functions for R type instruction
-void execute_i_type(const I_Instruction *instr, const int rd, const int rs1, const int imm, FILE *trace,
-                    int *pc_ptr, int *pc_location_ptr) {
-    // Case for JARL instruction only
-    if (instr->opcode == 0x67) {
-        // JALR opcode
+// "imm(rs1)" 형식의 메모리 operand를 분리. imm을 생략한 "(rs1)"은 offset 0
+int parse_memory_operand(char *token, int *imm, int *rs1) {
+    char *open_ptr = strchr(token, '(');
+    const size_t len = strlen(token);
 
-        fprintf_pc_into_trace_file(trace, pc_ptr);
+    if (open_ptr == NULL || len == 0 || token[len - 1] != ')') {
+        return 0;
+    }
+
+    *open_ptr = '\0';
+    token[len - 1] = '\0';
 
-        registers[rd] = registers[rs1] + imm;
+    char *imm_text = trim(token);
+    *imm = 0;
+    if (*imm_text != '\0' && !parse_immediate(imm_text, -2048, 2047, imm)) {
+        return 0;
+    }
 
-        *pc_location_ptr = registers[rd];
+    return parse_register(trim(open_ptr + 1), rs1);
+}
 
-        *pc_ptr = return_pc;
-        *pc_ptr += 4;
+// 레이블 이름은 영문자, 숫자, '_', '.' 로만 구성되고 숫자로 시작하지 않음
+int is_valid_label_name(const char *name) {
+    if (*name == '\0' || isdigit((unsigned char) *name) || strlen(name) >= MAX_LINE_LENGTH) {
+        return 0;
     }
 
-    // Case for opcode 0x13
-    else if (instr->opcode == 0x13) {
-        int shamt = 0;
-        switch (instr->funct3) {
-            case 0x0: // Case for ADDI
-                registers[rd] = registers[rs1] + imm;
-                break;
+    for (const char *ptr = name; *ptr != '\0'; ptr++) {
+        if (!isalnum((unsigned char) *ptr) && *ptr != '_' && *ptr != '.') {
+            return 0;
+        }
+    }
+    return 1;
+}
 
-            case 0x4: // Case for XORI
-                registers[rd] = registers[rs1] ^ imm;
-                break;
+// ','로 구분된 operand들을 나누어 operands[]에 저장하고 개수를 반환. 빈 operand가 있으면 -1
+int split_operands(char *text, char *operands[], const int max_count) {
+    text = trim(text);
+    if (*text == '\0') {
+        return 0;
+    }
 
-            case 0x6: // Case for ORI
-                registers[rd] = registers[rs1] | imm;
-                break;
+    int count = 0;
+    while (true) {
+        if (count == max_count) {
+            return -1;
+        }
 
-            case 0x7: // Case for ANDI
-                registers[rd] = registers[rs1] & imm;
-                break;
+        char *comma_ptr = strchr(text, ',');
+        if (comma_ptr != NULL) {
+            *comma_ptr = '\0';
+        }
 
-            case 0x1: // Case for SLLI
-                shamt = imm;
-                registers[rd] = registers[rs1] << shamt;
-                break;
+        operands[count] = trim(text);
+        if (*operands[count] == '\0') {
+            return -1;
+        }
+        count++;
 
-            case 0x5: // Case for SRLI & SRAI
-                shamt = imm & 0x1F; // shamt is lower 5 bits of imm
-                if (instr->funct7 == 0x00) {
-                    // SRLI (Shift Right Logical Immediate)
-                    registers[rd] = (uint32_t) registers[rs1] >> shamt;
-                } else if (instr->funct7 == 0x20) {
-                    // SRAI (Shift Right Arithmetic Immediate)
-                    registers[rd] = (int32_t) registers[rs1] >> shamt;
-                } else {
-                    // Invalid instruction
-                    printf("Invalid funct7 for shift instruction\n");
-                }
-                break;
+        if (comma_ptr == NULL) {
+            return count;
         }
+        text = comma_ptr + 1;
+    }
+}
 
-        *pc_location_ptr += 1;
-        fprintf_pc_into_trace_file(trace, pc_ptr);
-        *pc_ptr += 4;
+// 실제 명령어 하나를 decode. 문법에 맞지 않으면 0을 반환
+int parse_instruction(const char *name, char *operands[], const int count, Instruction *inst) {
+    memset(inst, 0, sizeof(Instruction));
+
+    // operation rd, rs1, rs2 format instruction -> R type
+    if ((inst->instr.r = find_r_instruction(name)) != NULL) {
+        inst->type = R_TYPE;
+        return count == 3 &&
+               parse_register(operands[0], &inst->rd) &&
+               parse_register(operands[1], &inst->rs1) &&
+               parse_register(operands[2], &inst->rs2);
     }
 
-    // Case for opcode is 0x3
-    else if (instr->opcode == 0x03) {
-        // LW 명령어 처리
-        switch (instr->funct3) {
-            case 0x2: {
-                const int address = registers[rs1] + imm;
-                const int word_address = address >> 2;
-
-                if (word_address >= 0 && word_address < 1024) {
-                    registers[rd] = memory[word_address];
-                } else {
-                    printf("Memory access error: address out of bounds\n");
-                }
-                break;
-            }
-            default:
-                printf("Unsupported funct3 for LW instruction\n");
-                break;
+    if ((inst->instr.i = find_i_instruction(name)) != NULL) {
+        inst->type = I_TYPE;
+
+        // operation rd, imm12(rs1) format instruction -> load & JALR
+        if (inst->instr.i->opcode == 0x03 || inst->instr.i->opcode == 0x67) {
+            return count == 2 &&
+                   parse_register(operands[0], &inst->rd) &&
+                   parse_memory_operand(operands[1], &inst->imm, &inst->rs1);
         }
 
-        *pc_location_ptr += 1;
-        fprintf_pc_into_trace_file(trace, pc_ptr);
-        *pc_ptr += 4;
+        // operation rd, rs1, shamt format instruction -> SLLI & SRLI & SRAI
+        const bool is_shift = inst->instr.i->funct3 == 0x1 || inst->instr.i->funct3 == 0x5;
+
+        // operation rd, rs1, imm12 format instruction
+        return count == 3 &&
+               parse_register(operands[0], &inst->rd) &&
+               parse_register(operands[1], &inst->rs1) &&
+               parse_immediate(operands[2], is_shift ? 0 : -2048, is_shift ? 31 : 2047, &inst->imm);
     }
-}
 
-// Execution functions for S type instruction
-void execute_s_type(const S_Instruction *instr, const int rs2, const int rs1,
-                    const int imm, FILE *trace, int *pc_ptr, int *pc_location_ptr) {
-    if (instr->funct3 == 0x2) {
-        // SW 명령어 처리
-        int address = registers[rs1] + imm;
-        int word_address = address >> 2; // 4로 나누기
-
-        // 메모리 범위 확인
-        if (word_address >= 0 && word_address < 1024) {
-            memory[word_address] = registers[rs2];
-        } else {
-            printf("Memory access error: address out of bounds\n");
+    // operation rs2, imm12(rs1) format instruction -> S type
+    if ((inst->instr.s = find_s_instruction(name)) != NULL) {
+        inst->type = S_TYPE;
+        return count == 2 &&
+               parse_register(operands[0], &inst->rs2) &&
+               parse_memory_operand(operands[1], &inst->imm, &inst->rs1);
+    }
+
+    // operation rs1, rs2, label format instruction -> SB type
+    if ((inst->instr.sb = find_sb_instruction(name)) != NULL) {
+        inst->type = SB_TYPE;
+        inst->relocation = BRANCH_OFFSET;
+        if (count != 3 || !is_valid_label_name(operands[2])) {
+            return 0;
         }
+        strcpy(inst->label, operands[2]);
+        return parse_register(operands[0], &inst->rs1) &&
+               parse_register(operands[1], &inst->rs2);
     }
 
-    *pc_location_ptr += 1;
-    fprintf_pc_into_trace_file(trace, pc_ptr);
-    *pc_ptr += 4;
+    // operation rd, imm20 format instruction -> U type
+    if ((inst->instr.u = find_u_instruction(name)) != NULL) {
+        inst->type = U_TYPE;
+        return count == 2 &&
+               parse_register(operands[0], &inst->rd) &&
+               parse_immediate(operands[1], 0, 0xFFFFF, &inst->imm);
+    }
+
+    // operation rd, label format instruction -> UJ type
+    if ((inst->instr.uj = find_uj_instruction(name)) != NULL) {
+        inst->type = UJ_TYPE;
+        inst->relocation = BRANCH_OFFSET;
+        if (count != 2 || !is_valid_label_name(operands[1])) {
+            return 0;
+        }
+        strcpy(inst->label, operands[1]);
+        return parse_register(operands[0], &inst->rd);
+    }
+
+    // EXIT
+    if (strcasecmp(name, "EXIT") == 0) {
+        inst->type = EXIT_TYPE;
+        return count == 0;
+    }
+
+    return 0;
 }
 
-// Execution functions for SB type instruction
-void execute_sb_type(const SB_Instruction *instr, const int rs1, const int rs2,
-                     const int imm, FILE *trace, int *pc_ptr, int *pc_location_ptr) {
-    int branch_condition_is_true = 0;
+int append_instruction(char *text);
 
-    switch (instr->funct3) {
-        case 0x0: // BEQ (Branch if Equal)
-            branch_condition_is_true = (registers[rs1] == registers[rs2]);
-            break;
+// pseudo 명령어를 실제 명령어로 확장하여 program[]에 추가
+// pseudo 명령어가 아니면 -1, 문법에 맞지 않으면 0, 성공하면 1을 반환
+int expand_pseudo_instruction(const char *name, char *operands[], const int count) {
+    char expanded[MAX_SOURCE_LINE_LENGTH] = {0,};
+    int rd = 0;
+    int imm = 0;
 
-        case 0x1: // BNE (Branch if Not Equal)
-            branch_condition_is_true = (registers[rs1] != registers[rs2]);
-            break;
+    // li rd, imm32 -> ADDI 또는 LUI (+ ADDI)
+    if (strcasecmp(name, "LI") == 0) {
+        if (count != 2 || !parse_register(operands[0], &rd) ||
+            !parse_immediate(operands[1], INT32_MIN, UINT32_MAX, &imm)) {
+            return 0;
+        }
 
-        case 0x4: // BLT (Branch if Less Than)
-            // signed comparison을 위해 int32_t로 캐스팅
-            branch_condition_is_true = ((int32_t) registers[rs1] < (int32_t) registers[rs2]);
-            break;
+        // ADDI의 imm은 부호 확장되므로 하위 12비트가 음수이면 상위 20비트에 1을 더해 보정
+        const int lo = ((imm & 0xFFF) ^ 0x800) - 0x800;
+        const int hi = (int) ((((uint32_t) imm - (uint32_t) lo) >> 12) & 0xFFFFF);
 
-        case 0x5: // BGE (Branch if Greater or Equal)
-            // signed comparison을 위해 int32_t로 캐스팅
-            branch_condition_is_true = ((int32_t) registers[rs1] >= (int32_t) registers[rs2]);
-            break;
+        if (hi == 0) {
+            snprintf(expanded, sizeof(expanded), "ADDI %s, x0, %d", operands[0], lo);
+            return append_instruction(expanded);
+        }
 
-        default:
-            printf("Invalid branch instruction funct3\n");
+        snprintf(expanded, sizeof(expanded), "LUI %s, %d", operands[0], hi);
+        if (!append_instruction(expanded)) {
+            return 0;
+        }
+
+        if (lo == 0) {
+            return 1;
+        }
+        snprintf(expanded, sizeof(expanded), "ADDI %s, %s, %d", operands[0], operands[0], lo);
+        return append_instruction(expanded);
     }
 
-    // 분기가 성공하면 PC를 업데이트
-    if (branch_condition_is_true) {
-        // imm은 이미 2를 곱한 값으로 가정 (word-aligned)
-        fprintf_pc_into_trace_file(trace, pc_ptr);
-        *pc_ptr = *pc_ptr + imm;
+    // la rd, label -> AUIPC rd, %pcrel_hi(label) + ADDI rd, rd, %pcrel_lo(label)
+    if (strcasecmp(name, "LA") == 0) {
+        if (count != 2 || !parse_register(operands[0], &rd) || !is_valid_label_name(operands[1])) {
+            return 0;
+        }
 
-        const int size = sizeof(labels) / sizeof(labels[0]);
+        snprintf(expanded, sizeof(expanded), "AUIPC %s, 0", operands[0]);
+        if (!append_instruction(expanded)) {
+            return 0;
+        }
+        program[instruction_count - 1].relocation = PCREL_HI;
+        strcpy(program[instruction_count - 1].label, operands[1]);
 
-        for (int i = 0; i < size; i++) {
-            if (*pc_ptr == labels[i].pc_address) {
-                *pc_location_ptr = labels[i].instruction_index;
-                break;
-            }
+        snprintf(expanded, sizeof(expanded), "ADDI %s, %s, 0", operands[0], operands[0]);
+        if (!append_instruction(expanded)) {
+            return 0;
         }
-    } else {
-        // 분기가 실패하면 다음 명령어로
-        *pc_location_ptr += 1;
-        fprintf_pc_into_trace_file(trace, pc_ptr);
-        *pc_ptr = *pc_ptr + 4;
+        program[instruction_count - 1].relocation = PCREL_LO;
+        strcpy(program[instruction_count - 1].label, operands[1]);
+        return 1;
     }
-}
 
-void execute_uj_type(const UJ_Instruction *instr, const int rd, const int imm, FILE *trace, int *pc_ptr,
-                     int *pc_location_ptr) {
-    fprintf_pc_into_trace_file(trace, pc_ptr);
-    return_pc = *pc_ptr;
-    registers[rd] = *pc_location_ptr + 1; // 프로시저 호출 다음 명령어 위치
-    *pc_ptr = *pc_ptr + imm;
+    const Pseudo_Instruction *pseudo = find_pseudo_instruction(name, count);
+    if (pseudo == NULL) {
+        return -1;
+    }
 
-    const int size = sizeof(labels) / sizeof(labels[0]);
-    for (int i = 0; i < size; i++) {
-        if (*pc_ptr == labels[i].pc_address) {
-            *pc_location_ptr = labels[i].instruction_index;
-            break;
+    // expansion의 %N을 N번째 operand로 치환. expanded에 다 들어가지 않으면 문법 오류로 봄
+    size_t length = 0;
+    for (const char *ptr = pseudo->expansion; *ptr != '\0'; ptr++) {
+        if (length >= sizeof(expanded) - 1) {
+            return 0;
+        }
+
+        if (*ptr == '%' && isdigit((unsigned char) ptr[1])) {
+            const int written = snprintf(expanded + length, sizeof(expanded) - length, "%s", operands[ptr[1] - '0']);
+            if (written < 0 || (size_t) written >= sizeof(expanded) - length) {
+                return 0;
+            }
+            length += written;
+            ptr++;
+        } else {
+            expanded[length++] = *ptr;
         }
     }
+    expanded[length] = '\0';
+
+    return append_instruction(expanded);
 }
 
-// =====================================================================================================================
-//
-// 핵심 동작을 수행하는 함수
-//
-// =====================================================================================================================
+// 명령어 한 줄을 decode하여 program[] 뒤에 추가. 문법에 맞지 않으면 0을 반환
+int append_instruction(char *text) {
+    char *operands[3] = {NULL,};
 
-int have_syntax_error_instruction(const char *filename) {
-    FILE *input_file = fopen(filename, "r");
-    char line[MAX_LINE_LENGTH] = {0,};
+    // 명령어 이름과 operand 분리
+    char *name = text;
+    while (*text != '\0' && !isspace((unsigned char) *text)) text++;
+    if (*text != '\0') {
+        *text = '\0';
+        text++;
+    }
 
-    while (fgets(line, sizeof(line), input_file)) {
-        char procedure_name[MAX_LINE_LENGTH] = {0,};
-        char jump_label_name[MAX_LINE_LENGTH] = {0,};
-        char instruction_name[MAX_LINE_LENGTH] = {0,};
-        int rd = 0, rs1 = 0, rs2 = 0, imm = 0;
-
-        if (sscanf(line, "%s x%d, x%d, x%d", instruction_name, &rd, &rs1, &rs2) == 4) {
-            const R_Instruction *r_instr = find_r_instruction(instruction_name);
-            if (r_instr == NULL) {
-                return 1;
+    const int count = split_operands(text, operands, 3);
+    if (count < 0) {
+        return 0;
+    }
+
+    const int expanded = expand_pseudo_instruction(name, operands, count);
+    if (expanded != -1) {
+        return expanded;
+    }
+
+    if (instruction_count == MAX_LINE_COUNT || !parse_instruction(name, operands, count, &program[instruction_count])) {
+        return 0;
+    }
+    instruction_count++;
+    return 1;
+}
+
+// .text, .data, .word 지시어 처리. 문법에 맞지 않으면 0을 반환
+int parse_directive(char *text, bool *in_data_section) {
+    char *operands[MAX_SOURCE_LINE_LENGTH / 2] = {NULL,};
+
+    char *name = text;
+    while (*text != '\0' && !isspace((unsigned char) *text)) text++;
+    if (*text != '\0') {
+        *text = '\0';
+        text++;
+    }
+
+    const int count = split_operands(text, operands, MAX_SOURCE_LINE_LENGTH / 2);
+
+    if (strcasecmp(name, ".text") == 0 || strcasecmp(name, ".data") == 0) {
+        *in_data_section = strcasecmp(name, ".data") == 0;
+        return count == 0;
+    }
+
+    // .word는 .data 영역에서만 사용하고, 값을 순서대로 data_segment_address부터 배치
+    if (strcasecmp(name, ".word") == 0) {
+        if (!*in_data_section || count <= 0) {
+            return 0;
+        }
+
+        for (int i = 0; i < count; i++) {
+            if (data_segment_address + (data_word_count + 1) * 4 > MEMORY_SIZE ||
+                !parse_immediate(operands[i], INT32_MIN, UINT32_MAX, &data_words[data_word_count])) {
+                return 0;
+            }
+            data_word_count++;
+        }
+        return 1;
+    }
+
+    return 0;
+}
+
+// =====================================================================================================================
+//
+// 각 타입에 맞게 동작을 구현한 코드
+//
+// =====================================================================================================================
+
+// RV32M 곱셈/나눗셈 커널
+// 상위 워드는 64비트 곱셈 한 번으로 구하고, 0으로 나누기와 overflow는 RISC-V 명세의 결과값을 그대로 돌려줌
+static inline int32_t mul_low(const int32_t a, const int32_t b) {
+    return (int32_t) ((uint32_t) a * (uint32_t) b); // signed overflow를 피하기 위해 unsigned로 곱함
+}
+
+static inline int32_t mul_high_signed(const int32_t a, const int32_t b) {
+    return (int32_t) (((int64_t) a * (int64_t) b) >> 32);
+}
+
+static inline int32_t mul_high_signed_unsigned(const int32_t a, const int32_t b) {
+    return (int32_t) (((int64_t) a * (int64_t) (uint32_t) b) >> 32);
+}
+
+static inline int32_t mul_high_unsigned(const int32_t a, const int32_t b) {
+    return (int32_t) (((uint64_t) (uint32_t) a * (uint64_t) (uint32_t) b) >> 32);
+}
+
+static inline int32_t div_signed(const int32_t a, const int32_t b) {
+    if (b == 0) return -1; // 0으로 나누면 모든 비트가 1
+    if (a == INT32_MIN && b == -1) return INT32_MIN; // overflow
+    return a / b;
+}
+
+static inline int32_t div_unsigned(const int32_t a, const int32_t b) {
+    if (b == 0) return -1; // 0xFFFFFFFF
+    return (int32_t) ((uint32_t) a / (uint32_t) b);
+}
+
+static inline int32_t rem_signed(const int32_t a, const int32_t b) {
+    if (b == 0) return a; // 0으로 나누면 피제수를 그대로 돌려줌
+    if (a == INT32_MIN && b == -1) return 0; // overflow
+    return a % b;
+}
+
+static inline int32_t rem_unsigned(const int32_t a, const int32_t b) {
+    if (b == 0) return a;
+    return (int32_t) ((uint32_t) a % (uint32_t) b);
+}
+
+// RV32M 연산 결과 계산 (funct7 = 0x01)
+int compute_m_extension(const R_Instruction *instr, const int32_t a, const int32_t b) {
+    switch (instr->funct3) {
+        case 0x0: // MUL
+            return mul_low(a, b);
+
+        case 0x1: // MULH
+            return mul_high_signed(a, b);
+
+        case 0x2: // MULHSU
+            return mul_high_signed_unsigned(a, b);
+
+        case 0x3: // MULHU
+            return mul_high_unsigned(a, b);
+
+        case 0x4: // DIV
+            return div_signed(a, b);
+
+        case 0x5: // DIVU
+            return div_unsigned(a, b);
+
+        case 0x6: // REM
+            return rem_signed(a, b);
+
+        case 0x7: // REMU
+            return rem_unsigned(a, b);
+
+        default:
+            return 0;
+    }
+}
+
+// R type 연산 결과 계산. a는 rs1, b는 rs2의 값
+int compute_r_type(const R_Instruction *instr, const int a, const int b) {
+    // Case for MUL, MULH, MULHSU, MULHU, DIV, DIVU, REM, REMU
+    if (instr->funct7 == 0x01) {
+        return compute_m_extension(instr, a, b);
+    }
+
+    const int shamt = b & 0x1F; // Extract shift amount (lower 5 bits)
+
+    switch (instr->funct3) {
+        // Case for ADD and SUB
+        case 0x0:
+            // Case for SUB
+            if (instr->funct7 == 0x20) {
+                return (int32_t) ((uint32_t) a - (uint32_t) b);
+            }
+
+            // Case for ADD
+            return (int32_t) ((uint32_t) a + (uint32_t) b);
+
+        // Case for SLL
+        case 0x1:
+            return (int32_t) ((uint32_t) a << shamt);
+
+        // Case for SLT
+        case 0x2:
+            return a < b;
+
+        // Case for SLTU
+        case 0x3:
+            return (uint32_t) a < (uint32_t) b;
+
+        // Case for XOR
+        case 0x4:
+            return a ^ b;
+
+        // Case for SRL & SRA
+        case 0x5:
+            if (instr->funct7 == 0x20) {
+                // SRA (Shift Right Arithmetic)
+                return a >> shamt; // Arithmetic shift
+            }
+
+            // SRL (Shift Right Logical)
+            return (int32_t) ((uint32_t) a >> shamt); // Logical shift
+
+        // Case for OR
+        case 0x6:
+            return a | b;
+
+        // Case for AND
+        case 0x7:
+            return a & b;
+
+        default:
+            return 0;
+    }
+}
+
+// opcode 0x13인 I type 연산 결과 계산. a는 rs1의 값
+int compute_i_type(const I_Instruction *instr, const int a, const int imm) {
+    const int shamt = imm & 0x1F; // shamt is lower 5 bits of imm
+
+    switch (instr->funct3) {
+        case 0x0: // Case for ADDI
+            return (int32_t) ((uint32_t) a + (uint32_t) imm);
+
+        case 0x2: // Case for SLTI
+            return a < imm;
+
+        case 0x3: // Case for SLTIU
+            return (uint32_t) a < (uint32_t) imm;
+
+        case 0x4: // Case for XORI
+            return a ^ imm;
+
+        case 0x6: // Case for ORI
+            return a | imm;
+
+        case 0x7: // Case for ANDI
+            return a & imm;
+
+        case 0x1: // Case for SLLI
+            return (int32_t) ((uint32_t) a << shamt);
+
+        case 0x5: // Case for SRLI & SRAI
+            if (instr->funct7 == 0x20) {
+                // SRAI (Shift Right Arithmetic Immediate)
+                return a >> shamt;
             }
-        } else if (sscanf(line, "%s x%d, x%d, %d", instruction_name, &rd, &rs1, &imm) == 4) {
-            const I_Instruction *i_instr = find_i_instruction(instruction_name);
-            if (i_instr == NULL) {
+
+            // SRLI (Shift Right Logical Immediate)
+            return (int32_t) ((uint32_t) a >> shamt);
+
+        default:
+            return 0;
+    }
+}
+
+// SB type 분기 조건 계산. a는 rs1, b는 rs2의 값
+int compute_branch_condition(const SB_Instruction *instr, const int a, const int b) {
+    switch (instr->funct3) {
+        case 0x0: // BEQ (Branch if Equal)
+            return a == b;
+
+        case 0x1: // BNE (Branch if Not Equal)
+            return a != b;
+
+        case 0x4: // BLT (Branch if Less Than)
+            // signed comparison을 위해 int32_t로 캐스팅
+            return (int32_t) a < (int32_t) b;
+
+        case 0x5: // BGE (Branch if Greater or Equal)
+            // signed comparison을 위해 int32_t로 캐스팅
+            return (int32_t) a >= (int32_t) b;
+
+        case 0x6: // BLTU (Branch if Less Than Unsigned)
+            return (uint32_t) a < (uint32_t) b;
+
+        case 0x7: // BGEU (Branch if Greater or Equal Unsigned)
+            return (uint32_t) a >= (uint32_t) b;
+
+        default:
+            report_runtime_error("Invalid branch instruction funct3");
+            return 0;
+    }
+}
+
+// Execution functions for R type instruction
+void execute_r_type(const R_Instruction *instr, const int rd, const int rs1, const int rs2, int regs[], FILE *trace, int *pc_ptr) {
+    regs[rd] = compute_r_type(instr, regs[rs1], regs[rs2]);
+
+    fprintf_pc_into_trace_file(trace, pc_ptr);
+    *pc_ptr += 4;
+}
+
+// Execution functions for I type instruction
+void execute_i_type(const I_Instruction *instr, const int rd, const int rs1, const int imm, int regs[],
+                    FILE *trace, int *pc_ptr) {
+    // Case for JARL instruction only
+    if (instr->opcode == 0x67) {
+        // JALR opcode
+        fprintf_pc_into_trace_file(trace, pc_ptr);
+
+        const int target = (int32_t) (((uint32_t) regs[rs1] + (uint32_t) imm) & ~1u); // rd와 rs1이 같은 경우를 위해 먼저 계산
+
+        regs[rd] = *pc_ptr + 4;
+
+        *pc_ptr = target;
+    }
+
+    // Case for opcode 0x13
+    else if (instr->opcode == 0x13) {
+        regs[rd] = compute_i_type(instr, regs[rs1], imm);
+
+        fprintf_pc_into_trace_file(trace, pc_ptr);
+        *pc_ptr += 4;
+    }
+
+    // Case for opcode is 0x3
+    else if (instr->opcode == 0x03) {
+        // LB, LH, LW, LBU, LHU 명령어 처리
+        // funct3의 하위 2비트는 접근 크기(1, 2, 4 바이트), 최상위 비트는 unsigned 여부
+        const int address = (int32_t) ((uint32_t) regs[rs1] + (uint32_t) imm);
+        const int size = 1 << (instr->funct3 & 0x3);
+        const bool is_unsigned = (instr->funct3 & 0x4) != 0;
+        int value = 0;
+
+        if (load_memory(address, size, is_unsigned, &value)) {
+            regs[rd] = value;
+        }
+
+        fprintf_pc_into_trace_file(trace, pc_ptr);
+        *pc_ptr += 4;
+    }
+}
+
+// Execution functions for S type instruction
+void execute_s_type(const S_Instruction *instr, const int rs2, const int rs1,
+                    const int imm, int regs[], FILE *trace, int *pc_ptr) {
+    // SB, SH, SW 명령어 처리. funct3가 접근 크기(1, 2, 4 바이트)를 결정
+    const int address = (int32_t) ((uint32_t) regs[rs1] + (uint32_t) imm);
+    store_memory(address, 1 << instr->funct3, regs[rs2]);
+
+    fprintf_pc_into_trace_file(trace, pc_ptr);
+    *pc_ptr += 4;
+}
+
+// Execution functions for SB type instruction
+void execute_sb_type(const SB_Instruction *instr, const int rs1, const int rs2,
+                     const int imm, int regs[], FILE *trace, int *pc_ptr) {
+    const int branch_condition_is_true = compute_branch_condition(instr, regs[rs1], regs[rs2]);
+
+    fprintf_pc_into_trace_file(trace, pc_ptr);
+
+    // 분기가 성공하면 PC를 레이블 위치로, 실패하면 다음 명령어로
+    if (branch_condition_is_true) {
+        *pc_ptr = *pc_ptr + imm;
+    } else {
+        *pc_ptr = *pc_ptr + 4;
+    }
+}
+
+// Execution functions for U type instruction
+void execute_u_type(const U_Instruction *instr, const int rd, const int imm, int regs[], FILE *trace, int *pc_ptr) {
+    const int upper = (int32_t) ((uint32_t) imm << 12);
+
+    if (instr->opcode == 0x37) {
+        // LUI
+        regs[rd] = upper;
+    } else if (instr->opcode == 0x17) {
+        // AUIPC
+        regs[rd] = (int32_t) ((uint32_t) *pc_ptr + (uint32_t) upper);
+    }
+
+    fprintf_pc_into_trace_file(trace, pc_ptr);
+    *pc_ptr += 4;
+}
+
+void execute_uj_type(const UJ_Instruction *instr, const int rd, const int imm, int regs[], FILE *trace, int *pc_ptr) {
+    fprintf_pc_into_trace_file(trace, pc_ptr);
+    regs[rd] = *pc_ptr + 4; // 프로시저 호출 다음 명령어 주소
+    *pc_ptr = *pc_ptr + imm;
+}
+
+// =====================================================================================================================
+//
+// 성능 측정 (단계별 시간, hardware counter)
+//
+// =====================================================================================================================
+
+typedef enum {
+    PARSE_STAGE, // have_syntax_error_instruction
+    LABEL_STAGE, // record_label
+    TRANSLATE_STAGE, // translate_assembly_instruction
+    TRACE_STAGE, // trace_pc
+    STAGE_COUNT
+} Stage;
+
+const char *stage_names[STAGE_COUNT] = {
+    "have_syntax_error_instruction", "record_label", "translate_assembly_instruction", "trace_pc"
+};
+
+double stage_seconds[STAGE_COUNT]; // 마지막으로 처리한 입력 파일의 단계별 실행 시간
+
+double monotonic_seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+void record_stage(const Stage stage, const double start) {
+    stage_seconds[stage] = monotonic_seconds() - start;
+}
+
+#define PERF_COUNTER_COUNT 6
+
+const char *perf_counter_names[PERF_COUNTER_COUNT] = {
+    "cycles", "instructions", "cache_references", "cache_misses", "branch_instructions", "branch_misses"
+};
+
+bool perf_counters_enabled = false; // true이면 trace_pc의 실행 루프에서 hardware counter를 측정
+long long perf_counts[PERF_COUNTER_COUNT]; // 측정하지 못한 counter는 -1
+
+#ifdef __linux__
+int perf_fds[PERF_COUNTER_COUNT];
+
+const unsigned long long perf_counter_configs[PERF_COUNTER_COUNT] = {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_REFERENCES,
+    PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES
+};
+#endif
+
+// 현재 process의 user 영역 counter를 켬. 권한이 없거나 지원하지 않는 counter는 건너뜀
+void start_perf_counters(void) {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        perf_counts[i] = -1;
+    }
+
+#ifdef __linux__
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        struct perf_event_attr attr;
+
+        memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = perf_counter_configs[i];
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        perf_fds[i] = (int) syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (perf_fds[i] >= 0) {
+            ioctl(perf_fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(perf_fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+void stop_perf_counters(void) {
+#ifdef __linux__
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        if (perf_fds[i] < 0) {
+            continue;
+        }
+
+        long long count = 0;
+        ioctl(perf_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+        if (read(perf_fds[i], &count, sizeof(count)) == (ssize_t) sizeof(count)) {
+            perf_counts[i] = count;
+        }
+        close(perf_fds[i]);
+    }
+#endif
+}
+
+// =====================================================================================================================
+//
+// 핵심 동작을 수행하는 함수
+//
+// =====================================================================================================================
+
+// 입력 파일을 decode하여 program[], labels[], data_words[]를 채움. .data는 data_address부터 배치
+// 문법에 맞지 않는 줄이 하나라도 있으면 1을 반환
+int have_syntax_error_instruction(const char *filename, const int data_address) {
+    FILE *input_file = fopen(filename, "r");
+    char line[MAX_SOURCE_LINE_LENGTH] = {0,};
+    bool in_data_section = false;
+
+    data_segment_address = data_address;
+    instruction_count = 0;
+    label_count = 0;
+    data_word_count = 0;
+
+    while (fgets(line, sizeof(line), input_file)) {
+        // '#' 뒤는 주석
+        char *comment_ptr = strchr(line, '#');
+        if (comment_ptr != NULL) {
+            *comment_ptr = '\0';
+        }
+
+        char *line_ptr = trim(line);
+
+        // 빈 줄은 건너뜀
+        if (*line_ptr == '\0') {
+            continue;
+        }
+
+        // "레이블:" 로 시작하면 레이블 이름을 저장하고 나머지를 명령어로 처리
+        char *colon_ptr = strchr(line_ptr, ':');
+        if (colon_ptr != NULL) {
+            *colon_ptr = '\0';
+            char *label_name = trim(line_ptr);
+
+            if (!is_valid_label_name(label_name) || find_label(label_name) != NULL || label_count == MAX_LINE_COUNT) {
+                fclose(input_file);
                 return 1;
             }
-        } else if (sscanf(line, "%s x%d, %d(x%d)", instruction_name, &rd, &imm, &rs1) == 4) {
-            const I_Instruction *i_instr = find_i_instruction(instruction_name); // Return LW only
-            const S_Instruction *s_instr = find_s_instruction(instruction_name); // Return SW only
 
-            if (i_instr == NULL) {
-                if (s_instr != NULL) {
-                    continue;
-                }
-                return 1;
-            }
-        } else if (sscanf(line, "%s x%d, x%d, %s", instruction_name, &rs1, &rs2, jump_label_name) == 4) {
-            const SB_Instruction *sb_instr = find_sb_instruction(instruction_name);
-            if (sb_instr == NULL) {
-                return 1;
+            strcpy(labels[label_count].name, label_name);
+            if (in_data_section) {
+                labels[label_count].instruction_index = -1;
+                labels[label_count].pc_address = data_segment_address + data_word_count * 4;
+            } else {
+                labels[label_count].instruction_index = instruction_count;
+            }
+            label_count++;
+
+            line_ptr = trim(colon_ptr + 1);
+            if (*line_ptr == '\0') {
+                continue;
+            }
+        }
+
+        int is_valid_line = 0;
+        if (*line_ptr == '.') {
+            is_valid_line = parse_directive(line_ptr, &in_data_section);
+        } else if (!in_data_section) {
+            is_valid_line = append_instruction(line_ptr);
+        }
+
+        if (!is_valid_line) {
+            fclose(input_file);
+            return 1;
+        }
+    }
+
+    fclose(input_file);
+    return 0;
+}
+
+// 레이블과 명령어에 PC를 부여하고 레이블을 참조하는 imm을 계산. 정의되지 않은 레이블이 있으면 1을 반환
+int record_label(void) {
+    for (int i = 0; i < label_count; i++) {
+        if (labels[i].instruction_index >= 0) {
+            labels[i].pc_address = STARTING_PC + labels[i].instruction_index * 4;
+        }
+    }
+
+    for (int i = 0; i < instruction_count; i++) {
+        Instruction *inst = &program[i];
+        inst->pc = STARTING_PC + i * 4;
+
+        if (inst->relocation == NO_RELOCATION) {
+            continue;
+        }
+
+        const Label *label = find_label(inst->label);
+        if (label == NULL) {
+            return 1;
+        }
+
+        if (inst->relocation == BRANCH_OFFSET) {
+            // 분기 대상은 명령어 레이블이어야 함
+            if (label->instruction_index < 0) {
+                return 1;
+            }
+
+            inst->imm = label->pc_address - inst->pc;
+
+            // SB 타입은 13비트, UJ 타입은 21비트 signed offset
+            const int range = inst->type == SB_TYPE ? 4096 : 1048576;
+            if (inst->imm < -range || inst->imm >= range) {
+                return 1;
+            }
+        } else {
+            // PCREL_LO는 바로 앞 AUIPC의 PC를 기준으로 함
+            const int offset = label->pc_address - (inst->relocation == PCREL_HI ? inst->pc : inst->pc - 4);
+            const int lo = ((offset & 0xFFF) ^ 0x800) - 0x800;
+
+            inst->imm = inst->relocation == PCREL_HI ? (int) ((((uint32_t) offset - (uint32_t) lo) >> 12) & 0xFFFFF) : lo;
+        }
+    }
+
+    return 0;
+}
+
+// decode된 명령어를 기계어로 변환하여 파일명.o에 기록
+int encode_instruction(const Instruction *inst) {
+    int imm1;
+    int imm2;
+
+    switch (inst->type) {
+        case R_TYPE:
+            return encode_r_type(inst->instr.r->funct7, inst->rs2, inst->rs1, inst->instr.r->funct3, inst->rd,
+                                 inst->instr.r->opcode);
+
+        case I_TYPE:
+            // SLLI & SRLI & SRAI 는 imm[11:5]에 funct7을 넣음
+            if (inst->instr.i->opcode == 0x13 && (inst->instr.i->funct3 == 0x1 || inst->instr.i->funct3 == 0x5)) {
+                return encode_i_type((inst->instr.i->funct7 << 5) | inst->imm, inst->rs1, inst->instr.i->funct3,
+                                     inst->rd, inst->instr.i->opcode);
+            }
+            return encode_i_type(inst->imm, inst->rs1, inst->instr.i->funct3, inst->rd, inst->instr.i->opcode);
+
+        case S_TYPE:
+            parse_imm_for_s_type_inst(inst->imm, &imm1, &imm2); // parse imm into two individual imm variables
+            return encode_s_type(imm1, inst->rs2, inst->rs1, inst->instr.s->funct3, imm2, inst->instr.s->opcode);
+
+        case SB_TYPE:
+            parse_imm_for_sb_type_inst(inst->imm, &imm1, &imm2);
+            return encode_sb_type(imm1, inst->rs2, inst->rs1, inst->instr.sb->funct3, imm2, inst->instr.sb->opcode);
+
+        case U_TYPE:
+            return encode_u_type(inst->imm, inst->rd, inst->instr.u->opcode);
+
+        case UJ_TYPE:
+            return encode_uj_type(parse_imm_for_uj_type_inst(inst->imm), inst->rd, inst->instr.uj->opcode);
+
+        case EXIT_TYPE:
+        default:
+            return EXIT_CODE;
+    }
+}
+
+// decode된 명령어를 "ADD x7, x1, x2" 형식의 문자열로 변환 (보고서 출력용)
+void format_instruction(const Instruction *inst, char *text, const size_t size) {
+    switch (inst->type) {
+        case R_TYPE:
+            snprintf(text, size, "%s x%d, x%d, x%d", inst->instr.r->name, inst->rd, inst->rs1, inst->rs2);
+            break;
+
+        case I_TYPE:
+            if (inst->instr.i->opcode == 0x03 || inst->instr.i->opcode == 0x67) {
+                snprintf(text, size, "%s x%d, %d(x%d)", inst->instr.i->name, inst->rd, inst->imm, inst->rs1);
+            } else if (inst->relocation == PCREL_LO) {
+                snprintf(text, size, "%s x%d, x%d, %%pcrel_lo(%s)", inst->instr.i->name, inst->rd, inst->rs1,
+                         inst->label);
+            } else {
+                snprintf(text, size, "%s x%d, x%d, %d", inst->instr.i->name, inst->rd, inst->rs1, inst->imm);
+            }
+            break;
+
+        case S_TYPE:
+            snprintf(text, size, "%s x%d, %d(x%d)", inst->instr.s->name, inst->rs2, inst->imm, inst->rs1);
+            break;
+
+        case SB_TYPE:
+            snprintf(text, size, "%s x%d, x%d, %s", inst->instr.sb->name, inst->rs1, inst->rs2, inst->label);
+            break;
+
+        case U_TYPE:
+            if (inst->relocation == PCREL_HI) {
+                snprintf(text, size, "%s x%d, %%pcrel_hi(%s)", inst->instr.u->name, inst->rd, inst->label);
+            } else {
+                snprintf(text, size, "%s x%d, 0x%X", inst->instr.u->name, inst->rd, inst->imm);
+            }
+            break;
+
+        case UJ_TYPE:
+            snprintf(text, size, "%s x%d, %s", inst->instr.uj->name, inst->rd, inst->label);
+            break;
+
+        case EXIT_TYPE:
+        default:
+            snprintf(text, size, "EXIT");
+            break;
+    }
+}
+
+void write_object_file(const char *output_file) {
+    FILE *output = create_output_file(output_file);
+
+    for (int i = 0; i < instruction_count; i++) {
+        // Write machine code in output file
+        print_binary_to_file(encode_instruction(&program[i]), output);
+    }
+
+    fclose(output);
+}
+
+void translate_assembly_instruction(const char *filename) {
+    char output_file[MAX_LINE_LENGTH + 8] = {0,};
+    make_output_filename(filename, ".o", output_file, sizeof(output_file));
+
+    write_object_file(output_file);
+
+    // printf("Files %s generated successfully.\n", output_file);
+}
+
+// inst 하나를 regs 위에서 실행하고 PC를 갱신. EXIT이면 0을 반환
+int execute_instruction(const Instruction *inst, int regs[], FILE *trace, int *pc) {
+    switch (inst->type) {
+        case R_TYPE:
+            execute_r_type(inst->instr.r, inst->rd, inst->rs1, inst->rs2, regs, trace, pc);
+            break;
+
+        case I_TYPE:
+            execute_i_type(inst->instr.i, inst->rd, inst->rs1, inst->imm, regs, trace, pc);
+            break;
+
+        case S_TYPE:
+            execute_s_type(inst->instr.s, inst->rs2, inst->rs1, inst->imm, regs, trace, pc);
+            break;
+
+        case SB_TYPE:
+            execute_sb_type(inst->instr.sb, inst->rs1, inst->rs2, inst->imm, regs, trace, pc);
+            break;
+
+        case U_TYPE:
+            execute_u_type(inst->instr.u, inst->rd, inst->imm, regs, trace, pc);
+            break;
+
+        case UJ_TYPE:
+            execute_uj_type(inst->instr.uj, inst->rd, inst->imm, regs, trace, pc);
+            break;
+
+        case EXIT_TYPE:
+            fprintf_pc_into_trace_file(trace, pc);
+            return 0;
+    }
+
+    regs[0] = 0; // x0는 항상 0
+    return 1;
+}
+
+// PC가 프로그램 범위 안의 명령어를 가리키는지
+bool is_valid_pc(const int pc, const int count) {
+    return pc >= STARTING_PC && pc < STARTING_PC + count * 4 && (pc - STARTING_PC) % 4 == 0;
+}
+
+int execution_counts[MAX_LINE_COUNT]; // 마지막 execute_program에서 명령어별 실행 횟수
+long long max_steps = 0; // 0이 아니면 execute_program은 명령어를 이 개수까지만 실행함
+bool step_limit_exceeded = false; // 마지막 execute_program이 max_steps에 걸려 중간에 멈췄는지
+
+// program[]을 STARTING_PC부터 실행하며 실행된 PC를 trace에 기록
+void execute_program(FILE *trace) {
+    load_data_segment();
+    memset(execution_counts, 0, sizeof(execution_counts));
+
+    int pc = STARTING_PC;
+    long long step_count = 0;
+
+    step_limit_exceeded = false;
+
+    // PC가 프로그램 범위를 벗어나면 실행 종료
+    while (is_valid_pc(pc, instruction_count)) {
+        const int index = (pc - STARTING_PC) / 4;
+
+        if (max_steps > 0 && step_count++ >= max_steps) {
+            step_limit_exceeded = true;
+            return;
+        }
+
+        execution_counts[index]++;
+
+        if (!execute_instruction(&program[index], registers, trace, &pc)) {
+            return;
+        }
+    }
+}
+
+void trace_pc(const char *filename) {
+    char trace_file[MAX_LINE_LENGTH + 8] = {0,};
+    make_output_filename(filename, ".trace", trace_file, sizeof(trace_file));
+    FILE *trace = create_output_file(trace_file);
+
+    if (perf_counters_enabled) {
+        start_perf_counters();
+    }
+
+    execute_program(trace);
+
+    if (perf_counters_enabled) {
+        stop_perf_counters();
+    }
+
+    fclose(trace);
+
+    // printf("Files %s generated successfully.\n", trace_file);
+}
+
+// =====================================================================================================================
+//
+// Multi-hart 실행
+//
+// =====================================================================================================================
+
+// hart에서 명령어 하나를 실행. 더 실행할 명령어가 없으면 false를 반환
+bool step_hart(Hart *hart) {
+    if (hart->halted) {
+        return false;
+    }
+
+    if (!is_valid_pc(hart->pc, hart->instruction_count)
+        || !execute_instruction(&hart->program[(hart->pc - STARTING_PC) / 4], hart->registers, hart->trace,
+                                &hart->pc)) {
+        hart->halted = true;
+        return false;
+    }
+
+    return true;
+}
+
+// 모든 hart 스레드를 만든 뒤에 실행을 시작하도록 막아 둠. 스레드를 다 만들지 못하면 취소함
+typedef enum {
+    HART_THREADS_WAITING,
+    HART_THREADS_RUNNING,
+    HART_THREADS_CANCELLED,
+} Hart_Threads_State;
+
+pthread_mutex_t hart_threads_lock = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t hart_threads_started = PTHREAD_COND_INITIALIZER;
+Hart_Threads_State hart_threads_state = HART_THREADS_WAITING;
+
+void set_hart_threads_state(const Hart_Threads_State state) {
+    pthread_mutex_lock(&hart_threads_lock);
+    hart_threads_state = state;
+    pthread_cond_broadcast(&hart_threads_started);
+    pthread_mutex_unlock(&hart_threads_lock);
+}
+
+void *run_hart_thread(void *arg) {
+    Hart *hart = arg;
+
+    pthread_mutex_lock(&hart_threads_lock);
+    while (hart_threads_state == HART_THREADS_WAITING) {
+        pthread_cond_wait(&hart_threads_started, &hart_threads_lock);
+    }
+    const bool cancelled = hart_threads_state == HART_THREADS_CANCELLED;
+    pthread_mutex_unlock(&hart_threads_lock);
+
+    while (!cancelled && step_hart(hart)) {
+    }
+
+    return NULL;
+}
+
+// 모든 hart가 끝날 때까지 명령어 하나씩 hart 0, 1, ... 순서로 번갈아 실행
+void run_harts_round_robin(Hart harts[], const int hart_count) {
+    int running_count = hart_count;
+
+    while (running_count > 0) {
+        running_count = 0;
+        for (int i = 0; i < hart_count; i++) {
+            running_count += step_hart(&harts[i]);
+        }
+    }
+}
+
+void run_harts_on_threads(Hart harts[], const int hart_count) {
+    pthread_t threads[MAX_HART_COUNT];
+    int thread_count = 0;
+
+    set_hart_threads_state(HART_THREADS_WAITING);
+    for (; thread_count < hart_count; thread_count++) {
+        if (pthread_create(&threads[thread_count], NULL, run_hart_thread, &harts[thread_count]) != 0) {
+            break;
+        }
+    }
+
+    // hart끼리 서로를 기다릴 수 있으므로 일부만 스레드로 실행하지 않고, 만든 스레드를 취소한 뒤 모두 번갈아 실행
+    const bool created_all = thread_count == hart_count;
+    set_hart_threads_state(created_all ? HART_THREADS_RUNNING : HART_THREADS_CANCELLED);
+
+    for (int i = 0; i < thread_count; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    if (!created_all) {
+        printf("Thread creation error: running harts round-robin\n");
+        run_harts_round_robin(harts, hart_count);
+    }
+}
+
+// input은 "a.s" 또는 "a.s,b.s" 형식. hart i는 (i % 파일 개수)번째 파일을 실행하고 파일명.hart<i>.trace를 생성
+// 모든 hart는 memory[]를 공유하며, 각 파일의 .data는 입력 순서대로 앞 파일의 .data 바로 뒤에 배치됨
+// hart i는 a0 = i, a1 = hart_count로 시작하므로 이 값으로 작업을 나눌 수 있음
+void run_harts(const char *input, const int hart_count, const Schedule_Mode mode) {
+    static Hart harts[MAX_HART_COUNT];
+    char files[MAX_LINE_LENGTH] = {0,};
+    char *filenames[MAX_HART_COUNT];
+    Instruction *images[MAX_HART_COUNT];
+    int counts[MAX_HART_COUNT];
+    int file_count = 0;
+    int data_address = DATA_SEGMENT_ADDRESS;
+    bool has_error = false;
+
+    strncpy(files, input, sizeof(files) - 1);
+
+    for (char *token = strtok(files, ","); token != NULL && file_count < MAX_HART_COUNT;
+         token = strtok(NULL, ",")) {
+        FILE *input_file = fopen(token, "r");
+
+        if (!input_file) {
+            printf("Input file does not exist!!\n");
+            has_error = true;
+            break;
+        }
+        fclose(input_file);
+
+        if (have_syntax_error_instruction(token, data_address) || record_label()) {
+            printf("Syntax Error!!\n");
+            has_error = true;
+            break;
+        }
+
+        translate_assembly_instruction(token);
+        load_data_segment();
+
+        images[file_count] = malloc(sizeof(Instruction) * (instruction_count > 0 ? instruction_count : 1));
+        memcpy(images[file_count], program, sizeof(Instruction) * instruction_count);
+        counts[file_count] = instruction_count;
+        filenames[file_count] = token;
+        file_count++;
+        data_address += data_word_count * 4;
+    }
+
+    if (!has_error && file_count > 0) {
+        for (int i = 0; i < hart_count; i++) {
+            char extension[16] = {0,};
+            char trace_file[MAX_LINE_LENGTH + 16] = {0,};
+            const int file = i % file_count;
+
+            snprintf(extension, sizeof(extension), ".hart%d.trace", i);
+            make_output_filename(filenames[file], extension, trace_file, sizeof(trace_file));
+
+            harts[i].program = images[file];
+            harts[i].instruction_count = counts[file];
+            memcpy(harts[i].registers, registers, sizeof(registers));
+            harts[i].registers[10] = i;
+            harts[i].registers[11] = hart_count;
+            harts[i].pc = STARTING_PC;
+            harts[i].trace = fopen(trace_file, "w");
+            harts[i].halted = false;
+        }
+
+        if (mode == THREAD_SCHEDULE) {
+            run_harts_on_threads(harts, hart_count);
+        } else {
+            run_harts_round_robin(harts, hart_count);
+        }
+
+        for (int i = 0; i < hart_count; i++) {
+            fclose(harts[i].trace);
+        }
+    }
+
+    for (int i = 0; i < file_count; i++) {
+        free(images[i]);
+    }
+}
+
+// =====================================================================================================================
+//
+// Batch 실행 (초기 register 값만 다른 여러 lane을 한 번에 실행)
+//
+// =====================================================================================================================
+
+// register 파일은 structure-of-arrays: batch_registers[r][lane]
+int32_t batch_registers[32][MAX_LANE_COUNT] __attribute__((aligned(32)));
+int32_t batch_pcs[MAX_LANE_COUNT] __attribute__((aligned(32))); // 끝난 lane과 빈 lane은 HALTED_LANE_PC
+int batch_initial_registers[MAX_LANE_COUNT][32];
+int batch_lane_count = 0;
+
+// 한 줄에 lane 하나. "a0=12 a1=0x20, x5=-3"처럼 register=값을 나열하고 적지 않은 register는 initialize_registers()의 값을 사용
+int load_batch_states(const char *filename) {
+    FILE *states_file = fopen(filename, "r");
+    char line[MAX_SOURCE_LINE_LENGTH] = {0,};
+    int line_number = 0;
+
+    if (!states_file) {
+        printf("Batch state file does not exist!!\n");
+        return 0;
+    }
+
+    initialize_registers();
+    batch_lane_count = 0;
+
+    while (fgets(line, sizeof(line), states_file)) {
+        line_number++;
+
+        char *comment_ptr = strchr(line, '#');
+        if (comment_ptr != NULL) {
+            *comment_ptr = '\0';
+        }
+        if (*trim(line) == '\0') {
+            continue;
+        }
+
+        if (batch_lane_count == MAX_LANE_COUNT) {
+            printf("Too many batch states (max %d)\n", MAX_LANE_COUNT);
+            fclose(states_file);
+            return 0;
+        }
+
+        int *lane_registers = batch_initial_registers[batch_lane_count];
+        memcpy(lane_registers, registers, sizeof(registers));
+
+        for (char *token = strtok(line, " \t,\r\n"); token != NULL; token = strtok(NULL, " \t,\r\n")) {
+            char *equal_ptr = strchr(token, '=');
+            int reg = 0;
+            int value = 0;
+
+            if (equal_ptr != NULL) {
+                *equal_ptr = '\0';
+            }
+            if (equal_ptr == NULL || !parse_register(token, &reg) || reg == 0
+                || !parse_immediate(equal_ptr + 1, INT32_MIN, UINT32_MAX, &value)) {
+                printf("Invalid batch state at line %d\n", line_number);
+                fclose(states_file);
+                return 0;
+            }
+
+            lane_registers[reg] = value;
+        }
+
+        batch_lane_count++;
+    }
+
+    fclose(states_file);
+
+    if (batch_lane_count == 0) {
+        printf("Batch state file is empty\n");
+        return 0;
+    }
+
+    return 1;
+}
+
+// 모든 lane에 대해 같은 연산을 하는 R type(RV32M 제외)과 opcode 0x13인 I type
+bool is_lane_parallel_instruction(const Instruction *inst) {
+    return (inst->type == R_TYPE && inst->instr.r->funct7 != 0x01)
+           || (inst->type == I_TYPE && inst->instr.i->opcode == 0x13);
+}
+
+#ifdef HAS_AVX2_KERNEL
+// PC가 pc인 lane의 rd에 연산 결과를 씀. 8개 lane씩 계산하고 다른 PC에 있는 lane은 blend로 원래 값을 유지
+// rs2_values가 NULL이면 I type으로 보고 모든 lane에 imm을 사용. alternate는 SUB, SRA, SRAI
+__attribute__((target("avx2")))
+void execute_alu_lanes_avx2(const int funct3, const bool alternate, int32_t *rd_values, const int32_t *rs1_values,
+                            const int32_t *rs2_values, const int imm, const int pc, const int lane_count) {
+    const __m256i pc_vector = _mm256_set1_epi32(pc);
+    const __m256i sign_bit = _mm256_set1_epi32(INT32_MIN);
+    const __m256i shift_mask = _mm256_set1_epi32(0x1F);
+
+    for (int lane = 0; lane < lane_count; lane += 8) {
+        const __m256i active = _mm256_cmpeq_epi32(_mm256_load_si256((const __m256i *) &batch_pcs[lane]), pc_vector);
+        if (_mm256_testz_si256(active, active)) {
+            continue;
+        }
+
+        const __m256i a = _mm256_load_si256((const __m256i *) &rs1_values[lane]);
+        const __m256i b = rs2_values != NULL
+                              ? _mm256_load_si256((const __m256i *) &rs2_values[lane])
+                              : _mm256_set1_epi32(imm);
+        const __m256i shamt = _mm256_and_si256(b, shift_mask);
+        __m256i result;
+
+        switch (funct3) {
+            case 0x0: // ADD, SUB, ADDI
+                result = alternate ? _mm256_sub_epi32(a, b) : _mm256_add_epi32(a, b);
+                break;
+
+            case 0x1: // SLL, SLLI
+                result = _mm256_sllv_epi32(a, shamt);
+                break;
+
+            case 0x2: // SLT, SLTI (비교 결과 -1을 1로)
+                result = _mm256_srli_epi32(_mm256_cmpgt_epi32(b, a), 31);
+                break;
+
+            case 0x3: // SLTU, SLTIU (부호 비트를 뒤집어 unsigned 비교)
+                result = _mm256_srli_epi32(_mm256_cmpgt_epi32(_mm256_xor_si256(b, sign_bit),
+                                                              _mm256_xor_si256(a, sign_bit)), 31);
+                break;
+
+            case 0x4: // XOR, XORI
+                result = _mm256_xor_si256(a, b);
+                break;
+
+            case 0x5: // SRL, SRA, SRLI, SRAI
+                result = alternate ? _mm256_srav_epi32(a, shamt) : _mm256_srlv_epi32(a, shamt);
+                break;
+
+            case 0x6: // OR, ORI
+                result = _mm256_or_si256(a, b);
+                break;
+
+            default: // AND, ANDI
+                result = _mm256_and_si256(a, b);
+                break;
+        }
+
+        const __m256i old_values = _mm256_load_si256((const __m256i *) &rd_values[lane]);
+        _mm256_store_si256((__m256i *) &rd_values[lane], _mm256_blendv_epi8(old_values, result, active));
+    }
+}
+#endif
+
+// PC가 pc인 모든 lane에서 R/I type 연산 inst를 실행
+void execute_alu_lanes(const Instruction *inst, const int pc, const int lane_count) {
+    if (inst->rd == 0) {
+        return;
+    }
+
+    const bool is_r_type = inst->type == R_TYPE;
+    const int funct3 = is_r_type ? inst->instr.r->funct3 : inst->instr.i->funct3;
+    const int funct7 = is_r_type ? inst->instr.r->funct7 : inst->instr.i->funct7;
+
+#ifdef HAS_AVX2_KERNEL
+    if (__builtin_cpu_supports("avx2")) {
+        execute_alu_lanes_avx2(funct3, funct7 == 0x20, batch_registers[inst->rd], batch_registers[inst->rs1],
+                               is_r_type ? batch_registers[inst->rs2] : NULL, inst->imm, pc, lane_count);
+        return;
+    }
+#else
+    (void) funct3;
+    (void) funct7;
+#endif
+
+    for (int lane = 0; lane < lane_count; lane++) {
+        if (batch_pcs[lane] != pc) {
+            continue;
+        }
+
+        const int a = batch_registers[inst->rs1][lane];
+        batch_registers[inst->rd][lane] = is_r_type
+                                              ? compute_r_type(inst->instr.r, a, batch_registers[inst->rs2][lane])
+                                              : compute_i_type(inst->instr.i, a, inst->imm);
+    }
+}
+
+// 분기, 점프, load/store처럼 lane마다 결과가 다른 명령어는 lane의 register와 메모리로 하나씩 실행
+void execute_lane(const Instruction *inst, const int lane, uint8_t *lane_memory, FILE *trace) {
+    int lane_registers[32];
+    int pc = batch_pcs[lane];
+
+    for (int r = 0; r < 32; r++) {
+        lane_registers[r] = batch_registers[r][lane];
+    }
+
+    execution_memory = lane_memory;
+    if (!execute_instruction(inst, lane_registers, trace, &pc)) {
+        pc = HALTED_LANE_PC;
+    }
+    execution_memory = memory;
+
+    for (int r = 0; r < 32; r++) {
+        batch_registers[r][lane] = lane_registers[r];
+    }
+    batch_pcs[lane] = pc;
+}
+
+// 매번 가장 작은 PC에 있는 lane들을 함께 실행. 분기로 갈라진 lane은 뒤처진 쪽이 따라와 같은 PC가 되면 다시 합쳐짐
+void execute_batch(uint8_t (*lane_memories)[MEMORY_SIZE], FILE *traces[]) {
+    const int lane_count = (batch_lane_count + 7) / 8 * 8; // 빈 lane을 채워 8의 배수로 맞춤
+
+    while (true) {
+        int pc = HALTED_LANE_PC;
+
+        for (int lane = 0; lane < batch_lane_count; lane++) {
+            if (batch_pcs[lane] == HALTED_LANE_PC) {
+                continue;
+            }
+            if (!is_valid_pc(batch_pcs[lane], instruction_count)) {
+                batch_pcs[lane] = HALTED_LANE_PC;
+                continue;
+            }
+            if (pc == HALTED_LANE_PC || batch_pcs[lane] < pc) {
+                pc = batch_pcs[lane];
+            }
+        }
+
+        if (pc == HALTED_LANE_PC) {
+            break;
+        }
+
+        const Instruction *inst = &program[(pc - STARTING_PC) / 4];
+
+        if (is_lane_parallel_instruction(inst)) {
+            execute_alu_lanes(inst, pc, lane_count);
+
+            for (int lane = 0; lane < batch_lane_count; lane++) {
+                if (batch_pcs[lane] == pc) {
+                    fprintf_pc_into_trace_file(traces[lane], &pc);
+                    batch_pcs[lane] += 4;
+                }
+            }
+        } else {
+            for (int lane = 0; lane < batch_lane_count; lane++) {
+                if (batch_pcs[lane] == pc) {
+                    execute_lane(inst, lane, lane_memories[lane], traces[lane]);
+                }
+            }
+        }
+    }
+}
+
+// program[]을 batch_initial_registers의 모든 lane에서 실행하고 lane마다 파일명.lane<i>.trace, 파일명.lane<i>.regs 생성
+// lane은 서로 다른 실행이므로 메모리도 lane마다 따로 둠
+void trace_batch(const char *filename) {
+    static FILE *traces[MAX_LANE_COUNT];
+    uint8_t (*lane_memories)[MEMORY_SIZE] = calloc(batch_lane_count, MEMORY_SIZE);
+
+    for (int lane = 0; lane < MAX_LANE_COUNT; lane++) {
+        batch_pcs[lane] = lane < batch_lane_count ? STARTING_PC : HALTED_LANE_PC;
+
+        for (int r = 0; r < 32; r++) {
+            batch_registers[r][lane] = lane < batch_lane_count ? batch_initial_registers[lane][r] : 0;
+        }
+    }
+
+    for (int lane = 0; lane < batch_lane_count; lane++) {
+        char extension[16] = {0,};
+        char trace_file[MAX_LINE_LENGTH + 16] = {0,};
+
+        snprintf(extension, sizeof(extension), ".lane%d.trace", lane);
+        make_output_filename(filename, extension, trace_file, sizeof(trace_file));
+        traces[lane] = fopen(trace_file, "w");
+
+        execution_memory = lane_memories[lane];
+        load_data_segment();
+    }
+    execution_memory = memory;
+
+    execute_batch(lane_memories, traces);
+
+    for (int lane = 0; lane < batch_lane_count; lane++) {
+        char extension[16] = {0,};
+        char registers_file[MAX_LINE_LENGTH + 16] = {0,};
+
+        fclose(traces[lane]);
+
+        snprintf(extension, sizeof(extension), ".lane%d.regs", lane);
+        make_output_filename(filename, extension, registers_file, sizeof(registers_file));
+        FILE *dump = fopen(registers_file, "w");
+
+        for (int r = 0; r < 32; r++) {
+            fprintf(dump, "x%d %s %d\n", r, abi_register_names[r], batch_registers[r][lane]);
+        }
+
+        fclose(dump);
+    }
+
+    free(lane_memories);
+}
+
+// =====================================================================================================================
+//
+// 제어 흐름 그래프 (CFG)
+//
+// =====================================================================================================================
+
+Basic_Block blocks[MAX_LINE_COUNT]; // 기본 블록 저장 배열
+int block_count = 0;
+int block_of_instruction[MAX_LINE_COUNT]; // 명령어 index -> 블록 index
+bool has_indirect_jump = false; // JALR이 하나라도 있으면 is_indirect_target 블록으로 가는 간선이 있다고 봄
+
+bool is_jalr_instruction(const Instruction *inst) {
+    return inst->type == I_TYPE && inst->instr.i->opcode == 0x67;
+}
+
+// 분기, 점프, EXIT 다음 명령어에서 새 블록이 시작됨
+bool is_block_terminator(const Instruction *inst) {
+    return inst->type == SB_TYPE || inst->type == UJ_TYPE || inst->type == EXIT_TYPE || is_jalr_instruction(inst);
+}
+
+// 레이블이 가리키는 명령어의 블록. 프로그램 끝을 가리키면 -1
+int block_of_label(const char *name) {
+    const Label *label = find_label(name);
+    if (label == NULL || label->instruction_index < 0 || label->instruction_index >= instruction_count) {
+        return -1;
+    }
+    return block_of_instruction[label->instruction_index];
+}
+
+void add_successor(Basic_Block *block, const int successor, const Edge_Type type) {
+    if (successor >= 0) {
+        block->successors[block->successor_count] = successor;
+        block->successor_types[block->successor_count] = type;
+        block->successor_count++;
+    }
+}
+
+// record_label 이후의 program[]을 레이블과 분기 위치에서 나누어 blocks[]를 만듦
+void build_cfg(void) {
+    static bool is_leader[MAX_LINE_COUNT + 1];
+    static bool is_indirect_target[MAX_LINE_COUNT + 1];
+    bool every_block_is_indirect_target = false;
+
+    memset(is_leader, 0, sizeof(is_leader));
+    memset(is_indirect_target, 0, sizeof(is_indirect_target));
+    has_indirect_jump = false;
+    block_count = 0;
+
+    is_leader[0] = true;
+    for (int i = 0; i < label_count; i++) {
+        if (labels[i].instruction_index >= 0) {
+            is_leader[labels[i].instruction_index] = true;
+        }
+    }
+
+    for (int i = 0; i < instruction_count; i++) {
+        const Instruction *inst = &program[i];
+
+        if (is_block_terminator(inst)) {
+            is_leader[i + 1] = true;
+        }
+
+        if (is_jalr_instruction(inst)) {
+            has_indirect_jump = true;
+        }
+
+        // 호출(JAL, JALR rd != x0) 다음 명령어는 JALR로 돌아오는 지점
+        if ((inst->type == UJ_TYPE || is_jalr_instruction(inst)) && inst->rd != 0) {
+            is_indirect_target[i + 1] = true;
+        }
+
+        // la로 주소를 얻은 명령어 레이블
+        if (inst->relocation == PCREL_HI) {
+            const Label *label = find_label(inst->label);
+            if (label != NULL && label->instruction_index >= 0) {
+                is_indirect_target[label->instruction_index] = true;
+            }
+        }
+
+        // 직접 작성한 AUIPC는 어느 주소든 만들 수 있음
+        if (inst->type == U_TYPE && inst->instr.u->opcode == 0x17 && inst->relocation == NO_RELOCATION) {
+            every_block_is_indirect_target = true;
+        }
+    }
+
+    for (int i = 0; i < instruction_count; i++) {
+        if (is_leader[i]) {
+            if (block_count > 0) {
+                blocks[block_count - 1].end = i;
+            }
+
+            Basic_Block *block = &blocks[block_count++];
+            memset(block, 0, sizeof(Basic_Block));
+            block->start = i;
+            block->is_indirect_target = every_block_is_indirect_target || is_indirect_target[i];
+        }
+        block_of_instruction[i] = block_count - 1;
+    }
+    if (block_count > 0) {
+        blocks[block_count - 1].end = instruction_count;
+    }
+
+    for (int b = 0; b < block_count; b++) {
+        Basic_Block *block = &blocks[b];
+        const Instruction *last = &program[block->end - 1];
+        const int fall_through = block->end < instruction_count ? b + 1 : -1;
+
+        if (last->type == SB_TYPE) {
+            add_successor(block, block_of_label(last->label), TAKEN_EDGE);
+            add_successor(block, fall_through, FALL_THROUGH_EDGE);
+        } else if (last->type == UJ_TYPE && last->rd == 0) {
+            add_successor(block, block_of_label(last->label), JUMP_EDGE);
+        } else if (last->type == UJ_TYPE) {
+            add_successor(block, block_of_label(last->label), CALL_EDGE);
+            add_successor(block, fall_through, RETURN_EDGE);
+        } else if (is_jalr_instruction(last)) {
+            block->has_indirect_successor = true;
+            if (last->rd != 0) {
+                add_successor(block, fall_through, RETURN_EDGE);
+            }
+        } else if (last->type != EXIT_TYPE) {
+            add_successor(block, fall_through, FALL_THROUGH_EDGE);
+        }
+    }
+}
+
+// =====================================================================================================================
+//
+// 지배자(dominator)와 자연 루프(natural loop) 분석, CFG 내보내기
+//
+// =====================================================================================================================
+
+int predecessor_offsets[MAX_LINE_COUNT + 1]; // predecessor_list에서 블록별 선행 블록의 시작 위치
+int predecessor_list[MAX_LINE_COUNT * 2];
+int reverse_postorder[MAX_LINE_COUNT]; // 첫 블록에서 도달할 수 있는 블록의 역후위 순서
+int reverse_postorder_number[MAX_LINE_COUNT]; // 도달할 수 없는 블록은 -1
+int reachable_block_count = 0;
+int immediate_dominators[MAX_LINE_COUNT]; // 도달할 수 없는 블록은 -1
+
+void compute_predecessors(void) {
+    memset(predecessor_offsets, 0, sizeof(predecessor_offsets));
+
+    for (int b = 0; b < block_count; b++) {
+        for (int s = 0; s < blocks[b].successor_count; s++) {
+            predecessor_offsets[blocks[b].successors[s] + 1]++;
+        }
+    }
+    for (int b = 0; b < block_count; b++) {
+        predecessor_offsets[b + 1] += predecessor_offsets[b];
+    }
+
+    static int filled[MAX_LINE_COUNT];
+    memset(filled, 0, sizeof(filled));
+    for (int b = 0; b < block_count; b++) {
+        for (int s = 0; s < blocks[b].successor_count; s++) {
+            const int successor = blocks[b].successors[s];
+            predecessor_list[predecessor_offsets[successor] + filled[successor]++] = b;
+        }
+    }
+}
+
+// 첫 블록에서 DFS하여 역후위 순서를 계산
+void compute_reverse_postorder(void) {
+    static int stack[MAX_LINE_COUNT];
+    static int next_successor[MAX_LINE_COUNT];
+    static int postorder[MAX_LINE_COUNT];
+    static bool visited[MAX_LINE_COUNT];
+    int depth = 0;
+    int count = 0;
+
+    memset(visited, 0, sizeof(visited));
+    reachable_block_count = 0;
+
+    if (block_count == 0) {
+        return;
+    }
+
+    stack[depth++] = 0;
+    next_successor[0] = 0;
+    visited[0] = true;
+
+    while (depth > 0) {
+        const int b = stack[depth - 1];
+
+        if (next_successor[b] < blocks[b].successor_count) {
+            const int successor = blocks[b].successors[next_successor[b]++];
+            if (!visited[successor]) {
+                visited[successor] = true;
+                next_successor[successor] = 0;
+                stack[depth++] = successor;
+            }
+        } else {
+            postorder[count++] = b;
+            depth--;
+        }
+    }
+
+    for (int b = 0; b < block_count; b++) {
+        reverse_postorder_number[b] = -1;
+    }
+    for (int i = 0; i < count; i++) {
+        reverse_postorder[i] = postorder[count - 1 - i];
+        reverse_postorder_number[reverse_postorder[i]] = i;
+    }
+    reachable_block_count = count;
+}
+
+int intersect_dominators(int a, int b) {
+    while (a != b) {
+        while (reverse_postorder_number[a] > reverse_postorder_number[b]) a = immediate_dominators[a];
+        while (reverse_postorder_number[b] > reverse_postorder_number[a]) b = immediate_dominators[b];
+    }
+    return a;
+}
+
+// Cooper, Harvey, Kennedy의 반복 알고리즘으로 immediate dominator를 계산
+void compute_dominators(void) {
+    for (int b = 0; b < block_count; b++) {
+        immediate_dominators[b] = -1;
+    }
+    if (reachable_block_count == 0) {
+        return;
+    }
+    immediate_dominators[0] = 0;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (int i = 1; i < reachable_block_count; i++) {
+            const int b = reverse_postorder[i];
+            int new_dominator = -1;
+
+            for (int p = predecessor_offsets[b]; p < predecessor_offsets[b + 1]; p++) {
+                const int predecessor = predecessor_list[p];
+                if (immediate_dominators[predecessor] == -1) {
+                    continue;
+                }
+                new_dominator = new_dominator == -1
+                                    ? predecessor
+                                    : intersect_dominators(predecessor, new_dominator);
+            }
+
+            if (new_dominator != immediate_dominators[b]) {
+                immediate_dominators[b] = new_dominator;
+                changed = true;
+            }
+        }
+    }
+}
+
+// a가 b를 지배하는지 (첫 블록에서 b로 가는 모든 경로가 a를 지나는지)
+bool dominates(const int a, int b) {
+    if (immediate_dominators[a] == -1 || immediate_dominators[b] == -1) {
+        return false;
+    }
+
+    while (b != a && b != 0) {
+        b = immediate_dominators[b];
+    }
+    return b == a;
+}
+
+// header가 from을 지배하면 from -> header는 back edge
+bool is_back_edge(const int from, const int header) {
+    return dominates(header, from);
+}
+
+// header로 들어오는 모든 back edge의 자연 루프를 in_loop[]에 표시하고 블록 개수를 반환
+int collect_natural_loop(const int header, bool in_loop[]) {
+    static int stack[MAX_LINE_COUNT];
+    int depth = 0;
+    int size = 1;
+
+    memset(in_loop, 0, sizeof(bool) * block_count);
+    in_loop[header] = true;
+
+    for (int p = predecessor_offsets[header]; p < predecessor_offsets[header + 1]; p++) {
+        const int source = predecessor_list[p];
+        if (is_back_edge(source, header) && !in_loop[source]) {
+            in_loop[source] = true;
+            stack[depth++] = source;
+            size++;
+        }
+    }
+
+    // back edge의 출발 블록에서 header를 지나지 않고 거슬러 올라갈 수 있는 블록이 루프 몸체
+    while (depth > 0) {
+        const int b = stack[--depth];
+        for (int p = predecessor_offsets[b]; p < predecessor_offsets[b + 1]; p++) {
+            const int predecessor = predecessor_list[p];
+            if (!in_loop[predecessor] && immediate_dominators[predecessor] != -1) {
+                in_loop[predecessor] = true;
+                stack[depth++] = predecessor;
+                size++;
+            }
+        }
+    }
+
+    return size;
+}
+
+bool is_loop_header(const int b) {
+    for (int p = predecessor_offsets[b]; p < predecessor_offsets[b + 1]; p++) {
+        if (is_back_edge(predecessor_list[p], b)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void analyze_cfg(void) {
+    build_cfg();
+    compute_predecessors();
+    compute_reverse_postorder();
+    compute_dominators();
+}
+
+const char *edge_type_names[] = {"taken", "fallthrough", "jump", "call", "return"};
+
+// 블록마다 포함된 루프 개수 (루프 중첩 깊이)
+void compute_loop_depths(int depths[]) {
+    static bool in_loop[MAX_LINE_COUNT];
+
+    memset(depths, 0, sizeof(int) * block_count);
+    for (int h = 0; h < block_count; h++) {
+        if (!is_loop_header(h)) {
+            continue;
+        }
+        collect_natural_loop(h, in_loop);
+        for (int b = 0; b < block_count; b++) {
+            depths[b] += in_loop[b];
+        }
+    }
+}
+
+// 파일명.cfg.dot 생성. 블록에는 PC 범위, 실행 횟수, 명령어를 표시하고 루프 header는 이중 테두리, back edge는 빨간색
+void export_cfg_dot(const char *filename) {
+    static int depths[MAX_LINE_COUNT];
+    char dot_file[MAX_LINE_LENGTH + 16] = {0,};
+    make_output_filename(filename, ".cfg.dot", dot_file, sizeof(dot_file));
+    FILE *dot = fopen(dot_file, "w");
+
+    analyze_cfg();
+    compute_loop_depths(depths);
+
+    fprintf(dot, "digraph cfg {\n");
+    fprintf(dot, "    node [shape=box, fontname=\"monospace\"];\n");
+
+    for (int b = 0; b < block_count; b++) {
+        const Basic_Block *block = &blocks[b];
+
+        fprintf(dot, "    B%d [label=\"B%d  %d-%d  executed: %d  loop depth: %d\\l", b, b, program[block->start].pc,
+                program[block->end - 1].pc, execution_counts[block->start], depths[b]);
+
+        for (int i = 0; i < label_count; i++) {
+            if (labels[i].instruction_index == block->start) {
+                fprintf(dot, "%s:\\l", labels[i].name);
+            }
+        }
+
+        for (int i = block->start; i < block->end; i++) {
+            char text[MAX_SOURCE_LINE_LENGTH] = {0,};
+            format_instruction(&program[i], text, sizeof(text));
+            fprintf(dot, "    %s\\l", text);
+        }
+
+        fprintf(dot, "\"%s%s];\n", is_loop_header(b) ? ", peripheries=2" : "",
+                immediate_dominators[b] == -1 ? ", style=dashed" : "");
+    }
+
+    for (int b = 0; b < block_count; b++) {
+        for (int s = 0; s < blocks[b].successor_count; s++) {
+            const int successor = blocks[b].successors[s];
+            const Edge_Type type = blocks[b].successor_types[s];
+
+            fprintf(dot, "    B%d -> B%d [label=\"%s\"%s%s];\n", b, successor, edge_type_names[type],
+                    is_back_edge(b, successor) ? ", color=red" : "",
+                    type == CALL_EDGE || type == RETURN_EDGE ? ", style=dashed" : "");
+        }
+    }
+
+    fprintf(dot, "}\n");
+    fclose(dot);
+}
+
+// JSON 문자열 출력 (", \ 만 escape)
+void fprintf_json_string(FILE *file, const char *text) {
+    fputc('"', file);
+    for (const char *ptr = text; *ptr != '\0'; ptr++) {
+        if (*ptr == '"' || *ptr == '\\') {
+            fputc('\\', file);
+        }
+        fputc(*ptr, file);
+    }
+    fputc('"', file);
+}
+
+// 파일명.cfg.json 생성. 블록, 간선, immediate dominator, 자연 루프와 실행 횟수를 기록
+void export_cfg_json(const char *filename) {
+    static int depths[MAX_LINE_COUNT];
+    static bool in_loop[MAX_LINE_COUNT];
+    char json_file[MAX_LINE_LENGTH + 16] = {0,};
+    make_output_filename(filename, ".cfg.json", json_file, sizeof(json_file));
+    FILE *json = fopen(json_file, "w");
+
+    analyze_cfg();
+    compute_loop_depths(depths);
+
+    fprintf(json, "{\n  \"file\": ");
+    fprintf_json_string(json, filename);
+    fprintf(json, ",\n  \"blocks\": [");
+
+    for (int b = 0; b < block_count; b++) {
+        const Basic_Block *block = &blocks[b];
+
+        fprintf(json, "%s\n    {\"id\": %d, \"start_pc\": %d, \"end_pc\": %d, \"executed\": %d, \"loop_depth\": %d",
+                b == 0 ? "" : ",", b, program[block->start].pc, program[block->end - 1].pc,
+                execution_counts[block->start], depths[b]);
+
+        if (immediate_dominators[b] == -1) {
+            fprintf(json, ", \"idom\": null");
+        } else {
+            fprintf(json, ", \"idom\": %d", immediate_dominators[b]);
+        }
+
+        fprintf(json, ", \"labels\": [");
+        bool first = true;
+        for (int i = 0; i < label_count; i++) {
+            if (labels[i].instruction_index == block->start) {
+                fprintf(json, "%s", first ? "" : ", ");
+                fprintf_json_string(json, labels[i].name);
+                first = false;
+            }
+        }
+
+        fprintf(json, "], \"instructions\": [");
+        for (int i = block->start; i < block->end; i++) {
+            char text[MAX_SOURCE_LINE_LENGTH] = {0,};
+            format_instruction(&program[i], text, sizeof(text));
+            fprintf(json, "%s", i == block->start ? "" : ", ");
+            fprintf_json_string(json, text);
+        }
+
+        fprintf(json, "], \"successors\": [");
+        for (int s = 0; s < block->successor_count; s++) {
+            fprintf(json, "%s{\"block\": %d, \"type\": \"%s\", \"back_edge\": %s}", s == 0 ? "" : ", ",
+                    block->successors[s], edge_type_names[block->successor_types[s]],
+                    is_back_edge(b, block->successors[s]) ? "true" : "false");
+        }
+        fprintf(json, "], \"indirect_successor\": %s}", block->has_indirect_successor ? "true" : "false");
+    }
+
+    fprintf(json, "\n  ],\n  \"loops\": [");
+
+    bool first_loop = true;
+    for (int h = 0; h < block_count; h++) {
+        if (!is_loop_header(h)) {
+            continue;
+        }
+
+        collect_natural_loop(h, in_loop);
+
+        fprintf(json, "%s\n    {\"header\": %d, \"header_executed\": %d, \"back_edges_from\": [",
+                first_loop ? "" : ",", h, execution_counts[blocks[h].start]);
+        first_loop = false;
+
+        bool first = true;
+        for (int p = predecessor_offsets[h]; p < predecessor_offsets[h + 1]; p++) {
+            if (is_back_edge(predecessor_list[p], h)) {
+                fprintf(json, "%s%d", first ? "" : ", ", predecessor_list[p]);
+                first = false;
+            }
+        }
+
+        fprintf(json, "], \"blocks\": [");
+        first = true;
+        for (int b = 0; b < block_count; b++) {
+            if (in_loop[b]) {
+                fprintf(json, "%s%d", first ? "" : ", ", b);
+                first = false;
+            }
+        }
+        fprintf(json, "]}");
+    }
+
+    fprintf(json, "%s]\n}\n", first_loop ? "" : "\n  ");
+    fclose(json);
+}
+
+// =====================================================================================================================
+//
+// 최적화 (dead write 제거, constant propagation)
+//
+// =====================================================================================================================
+
+Register_Value block_entry_values[MAX_LINE_COUNT][32]; // 블록 시작 시점의 register 상수 정보
+uint32_t block_live_in[MAX_LINE_COUNT]; // 블록 시작 시점에 이후 읽히는 register 집합
+
+// 명령어가 값을 쓰는 register. 쓰지 않으면 -1
+int destination_register(const Instruction *inst) {
+    switch (inst->type) {
+        case R_TYPE:
+        case I_TYPE:
+        case U_TYPE:
+        case UJ_TYPE:
+            return inst->rd;
+
+        default:
+            return -1;
+    }
+}
+
+// 명령어가 읽는 register 집합 (x0 제외)
+uint32_t source_register_mask(const Instruction *inst) {
+    uint32_t mask = 0;
+
+    switch (inst->type) {
+        case R_TYPE:
+        case S_TYPE:
+        case SB_TYPE:
+            mask = (1u << inst->rs1) | (1u << inst->rs2);
+            break;
+
+        case I_TYPE:
+            mask = 1u << inst->rs1;
+            break;
+
+        default:
+            break;
+    }
+
+    return mask & ~1u;
+}
+
+// 결과를 쓰는 것 외에 부작용이 없는 명령어 (메모리 접근, 분기 제외)
+bool is_pure_instruction(const Instruction *inst) {
+    return inst->type == R_TYPE || inst->type == U_TYPE ||
+           (inst->type == I_TYPE && inst->instr.i->opcode == 0x13);
+}
+
+Register_Value meet_register_value(const Register_Value a, const Register_Value b) {
+    if (a.kind == UNDEFINED_VALUE) return b;
+    if (b.kind == UNDEFINED_VALUE) return a;
+    if (a.kind == CONSTANT_VALUE && b.kind == CONSTANT_VALUE && a.value == b.value) return a;
+    return (Register_Value) {VARIABLE_VALUE, 0};
+}
+
+// 명령어 하나를 실행한 뒤의 register 상수 정보로 values[]를 갱신
+void propagate_constants(const Instruction *inst, Register_Value values[32]) {
+    const int rd = destination_register(inst);
+    if (rd <= 0) {
+        return;
+    }
+
+    // AUIPC, JAL, JALR의 결과는 PC에 따라 달라지고 load 결과는 알 수 없으므로 상수로 취급하지 않음
+    Register_Value result = {VARIABLE_VALUE, 0};
+
+    if (inst->type == R_TYPE || (inst->type == I_TYPE && inst->instr.i->opcode == 0x13)) {
+        const Register_Value a = values[inst->rs1];
+        const Register_Value b = inst->type == R_TYPE ? values[inst->rs2] : (Register_Value) {CONSTANT_VALUE, inst->imm};
+
+        if (a.kind == VARIABLE_VALUE || b.kind == VARIABLE_VALUE) {
+            result.kind = VARIABLE_VALUE;
+        } else if (a.kind == UNDEFINED_VALUE || b.kind == UNDEFINED_VALUE) {
+            result.kind = UNDEFINED_VALUE;
+        } else {
+            result.kind = CONSTANT_VALUE;
+            result.value = inst->type == R_TYPE
+                               ? compute_r_type(inst->instr.r, a.value, b.value)
+                               : compute_i_type(inst->instr.i, a.value, b.value);
+        }
+    } else if (inst->type == U_TYPE && inst->instr.u->opcode == 0x37) {
+        result.kind = CONSTANT_VALUE;
+        result.value = (int32_t) ((uint32_t) inst->imm << 12);
+    }
+
+    values[rd] = result;
+}
+
+// 블록마다 시작 시점의 register 상수 정보를 고정점까지 계산
+void analyze_constants(void) {
+    for (int b = 0; b < block_count; b++) {
+        block_entry_values[b][0] = (Register_Value) {CONSTANT_VALUE, 0}; // x0는 항상 0
+        for (int r = 1; r < 32; r++) {
+            const bool unknown_entry = has_indirect_jump && blocks[b].is_indirect_target;
+            block_entry_values[b][r] = (Register_Value) {unknown_entry ? VARIABLE_VALUE : UNDEFINED_VALUE, 0};
+        }
+    }
+
+    // 첫 블록은 initialize_registers()의 초기값에서 시작
+    initialize_registers();
+    for (int r = 0; r < 32 && block_count > 0; r++) {
+        block_entry_values[0][r] = meet_register_value(block_entry_values[0][r],
+                                                       (Register_Value) {CONSTANT_VALUE, registers[r]});
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (int b = 0; b < block_count; b++) {
+            Register_Value values[32];
+            memcpy(values, block_entry_values[b], sizeof(values));
+
+            for (int i = blocks[b].start; i < blocks[b].end; i++) {
+                propagate_constants(&program[i], values);
+            }
+
+            for (int s = 0; s < blocks[b].successor_count; s++) {
+                Register_Value *entry = block_entry_values[blocks[b].successors[s]];
+
+                for (int r = 1; r < 32; r++) {
+                    const Register_Value merged = meet_register_value(entry[r], values[r]);
+                    if (merged.kind != entry[r].kind || merged.value != entry[r].value) {
+                        entry[r] = merged;
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// 블록이 끝난 뒤 읽힐 수 있는 register 집합. JALR 뒤는 알 수 없으므로 모두 읽힌다고 봄
+uint32_t block_live_out(const int b) {
+    if (blocks[b].has_indirect_successor) {
+        return ~1u;
+    }
+
+    uint32_t live = 0;
+    for (int s = 0; s < blocks[b].successor_count; s++) {
+        live |= block_live_in[blocks[b].successors[s]];
+    }
+    return live;
+}
+
+// 블록마다 시작 시점의 live register 집합을 고정점까지 계산
+void analyze_liveness(void) {
+    memset(block_live_in, 0, sizeof(block_live_in));
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (int b = block_count - 1; b >= 0; b--) {
+            uint32_t live = block_live_out(b);
+
+            for (int i = blocks[b].end - 1; i >= blocks[b].start; i--) {
+                const int rd = destination_register(&program[i]);
+                if (rd > 0) {
+                    live &= ~(1u << rd);
+                }
+                live |= source_register_mask(&program[i]);
+            }
+
+            if (live != block_live_in[b]) {
+                block_live_in[b] = live;
+                changed = true;
+            }
+        }
+    }
+}
+
+// 최적화 보고서에 "PC  명령어" 형식으로 한 줄 기록
+void report_instruction(FILE *report, const char *kind, const Instruction *inst, const char *detail) {
+    char text[MAX_SOURCE_LINE_LENGTH] = {0,};
+    format_instruction(inst, text, sizeof(text));
+    if (*detail == '\0') {
+        fprintf(report, "  %-12s %5d  %s\n", kind, inst->original_pc, text);
+    } else {
+        fprintf(report, "  %-12s %5d  %-32s %s\n", kind, inst->original_pc, text, detail);
+    }
+}
+
+// 결과가 상수인 명령어를 ADDI rd, x0, imm 또는 LUI rd, imm 하나로 바꿈. 바꾸었으면 1을 반환
+int fold_constant_result(Instruction *inst, const int value, FILE *report) {
+    const bool is_load_immediate =
+        (inst->type == I_TYPE && inst->instr.i->opcode == 0x13 && inst->instr.i->funct3 == 0x0 && inst->rs1 == 0) ||
+        (inst->type == U_TYPE && inst->instr.u->opcode == 0x37);
+
+    if (is_load_immediate || inst->relocation != NO_RELOCATION) {
+        return 0;
+    }
+
+    Instruction folded = *inst;
+    folded.rs1 = 0;
+    folded.rs2 = 0;
+
+    if (value >= -2048 && value <= 2047) {
+        folded.type = I_TYPE;
+        folded.instr.i = find_i_instruction("ADDI");
+        folded.imm = value;
+    } else if ((value & 0xFFF) == 0) {
+        folded.type = U_TYPE;
+        folded.instr.u = find_u_instruction("LUI");
+        folded.imm = (int) (((uint32_t) value >> 12) & 0xFFFFF);
+    } else {
+        return 0;
+    }
+
+    char detail[MAX_SOURCE_LINE_LENGTH + 8] = {0,};
+    char text[MAX_SOURCE_LINE_LENGTH] = {0,};
+    format_instruction(&folded, text, sizeof(text));
+    snprintf(detail, sizeof(detail), "-> %s", text);
+    report_instruction(report, "constant", inst, detail);
+
+    *inst = folded;
+    return 1;
+}
+
+// 제거된 명령어를 빼고 program[]을 다시 배치. 레이블은 다음으로 남은 명령어를 가리키게 함
+void compact_program(const bool removed[]) {
+    static int new_index[MAX_LINE_COUNT + 1];
+    int count = 0;
+
+    for (int i = 0; i < instruction_count; i++) {
+        new_index[i] = count;
+        if (!removed[i]) {
+            program[count++] = program[i];
+        }
+    }
+    new_index[instruction_count] = count;
+
+    for (int i = 0; i < label_count; i++) {
+        if (labels[i].instruction_index >= 0) {
+            labels[i].instruction_index = new_index[labels[i].instruction_index];
+        }
+    }
+
+    instruction_count = count;
+    record_label();
+}
+
+// 직접 작성한 AUIPC나 상수 주소로의 JALR은 명령어 위치가 바뀌면 의미가 달라지므로 재배치할 수 없음
+// 그런 명령어의 index를 반환하고, 없으면 -1
+int find_pc_dependent_instruction(void) {
+    for (int b = 0; b < block_count; b++) {
+        Register_Value values[32];
+        memcpy(values, block_entry_values[b], sizeof(values));
+
+        for (int i = blocks[b].start; i < blocks[b].end; i++) {
+            const Instruction *inst = &program[i];
+
+            if ((inst->type == U_TYPE && inst->instr.u->opcode == 0x17 && inst->relocation == NO_RELOCATION) ||
+                (is_jalr_instruction(inst) && values[inst->rs1].kind == CONSTANT_VALUE)) {
+                return i;
+            }
+
+            propagate_constants(inst, values);
+        }
+    }
+
+    return -1;
+}
+
+// 한 번의 분석 결과로 상수 결과 치환, 항상/절대 성립하는 분기 정리, dead write 제거를 수행
+// 변경이 있으면 1, 없으면 0, 재배치할 수 없으면 -1을 반환
+int run_optimization_pass(FILE *report) {
+    static bool removed[MAX_LINE_COUNT];
+    int changes = 0;
+
+    memset(removed, 0, sizeof(removed));
+
+    build_cfg();
+    analyze_constants();
+
+    const int pc_dependent = find_pc_dependent_instruction();
+    if (pc_dependent >= 0) {
+        report_instruction(report, "unsafe", &program[pc_dependent], "-> PC dependent, optimization stopped");
+        return -1;
+    }
+
+    for (int b = 0; b < block_count; b++) {
+        Register_Value values[32];
+        memcpy(values, block_entry_values[b], sizeof(values));
+
+        for (int i = blocks[b].start; i < blocks[b].end; i++) {
+            Instruction *inst = &program[i];
+            const Register_Value a = values[inst->rs1];
+            const Register_Value c = values[inst->rs2];
+
+            if (inst->type == SB_TYPE && a.kind == CONSTANT_VALUE && c.kind == CONSTANT_VALUE) {
+                if (compute_branch_condition(inst->instr.sb, a.value, c.value)) {
+                    // 항상 분기 -> JAL x0, label
+                    report_instruction(report, "branch", inst, "-> always taken");
+                    inst->type = UJ_TYPE;
+                    inst->instr.uj = find_uj_instruction("JAL");
+                    inst->rd = 0;
+                    inst->rs1 = 0;
+                    inst->rs2 = 0;
+                } else {
+                    report_instruction(report, "branch", inst, "-> never taken");
+                    removed[i] = true;
+                }
+                changes++;
+            }
+
+            propagate_constants(inst, values);
+
+            const int rd = destination_register(inst);
+            if (rd > 0 && is_pure_instruction(inst) && values[rd].kind == CONSTANT_VALUE) {
+                changes += fold_constant_result(inst, values[rd].value, report);
+            }
+        }
+    }
+
+    // 분기를 정리했으면 CFG가 바뀌므로 다음 pass에서 liveness를 계산
+    if (changes > 0) {
+        compact_program(removed);
+        return 1;
+    }
+
+    analyze_liveness();
+
+    for (int b = 0; b < block_count; b++) {
+        uint32_t live = block_live_out(b);
+
+        for (int i = blocks[b].end - 1; i >= blocks[b].start; i--) {
+            const Instruction *inst = &program[i];
+            const int rd = destination_register(inst);
+
+            // 값을 쓴 register가 이후 읽히지 않으면 dead write
+            if (is_pure_instruction(inst) && (rd == 0 || (live & (1u << rd)) == 0)) {
+                report_instruction(report, "dead write", inst, "");
+                removed[i] = true;
+                changes++;
+                continue;
             }
-        } else if (sscanf(line, "%s x%d, %s", instruction_name, &rd, procedure_name) == 3) {
-            const UJ_Instruction *uj_instr = find_uj_instruction(instruction_name);
-            if (uj_instr == NULL) {
-                return 1;
+
+            if (rd > 0) {
+                live &= ~(1u << rd);
             }
+            live |= source_register_mask(inst);
         }
     }
 
+    if (changes > 0) {
+        compact_program(removed);
+        return 1;
+    }
     return 0;
 }
 
-void record_label(const char *filename) {
-    FILE *input_file = fopen(filename, "r");
+// 파일명.opt.report에 최적화 내용을 기록하고, OPTIMIZE_RUN이면 최적화된 프로그램을
+// 파일명.opt.o로 변환한 뒤 실행하여 "PC 원래PC" 형식의 파일명.opt.trace를 생성
+void optimize_program(const char *filename, const Optimize_Mode mode) {
+    char report_file[MAX_LINE_LENGTH + 16] = {0,};
+    make_output_filename(filename, ".opt.report", report_file, sizeof(report_file));
+    FILE *report = fopen(report_file, "w");
 
-    char line[MAX_LINE_LENGTH] = {0,};
-    int pc = STARTING_PC;
-    int label_count = 0;
-    int index = 0;
+    const int original_count = instruction_count;
+    for (int i = 0; i < instruction_count; i++) {
+        program[i].original_pc = program[i].pc;
+    }
 
-    while (fgets(line, sizeof(line), input_file)) {
-        char *line_ptr = line;
+    fprintf(report, "%s\n", filename);
 
-        // 앞쪽 공백 제거
-        while (isspace(*line_ptr)) line_ptr++;
-        if (*line_ptr == '\0' || *line_ptr == '\n') continue; // 빈 줄은 건너뜀
+    int result = 1;
+    for (int pass = 1; result == 1; pass++) {
+        fprintf(report, "pass %d\n", pass);
+        result = run_optimization_pass(report);
+    }
 
-        // 라인이 레이블인지 확인
-        char *colon_ptr = strchr(line_ptr, ':');
-        if (colon_ptr) {
-            // 레이블임
-            size_t label_len = colon_ptr - line_ptr;
-            char label_name[MAX_LINE_LENGTH] = {0,};
-            strncpy(label_name, line_ptr, label_len);
-            label_name[label_len] = '\0';
-
-            // 레이블 이름과 현재 pc를 labels[] 배열에 저장
-            strcpy(labels[label_count].name, label_name);
-            labels[label_count].pc_address = pc;
-            labels[label_count].instruction_index = index;
-            index++;
-            label_count++;
-        } else {
-            index++;
-            pc += 4;
-        }
+    fprintf(report, "instructions: %d -> %d\n", original_count, instruction_count);
+    fclose(report);
+
+    if (mode != OPTIMIZE_RUN) {
+        return;
     }
 
-    fclose(input_file);
+    char output_file[MAX_LINE_LENGTH + 16] = {0,};
+    make_output_filename(filename, ".opt.o", output_file, sizeof(output_file));
+    write_object_file(output_file);
+
+    char trace_file[MAX_LINE_LENGTH + 16] = {0,};
+    make_output_filename(filename, ".opt.trace", trace_file, sizeof(trace_file));
+    FILE *trace = fopen(trace_file, "w");
+
+    initialize_registers();
+    initialize_memory();
+
+    annotate_original_pc = true;
+    execute_program(trace);
+    annotate_original_pc = false;
+
+    fclose(trace);
 }
 
-// Add other encoding functions for S-type, SB-type, U-type, and UJ-type
-void translate_assembly_instruction(const char *filename) {
-    FILE *input_file = fopen(filename, "r");
+// =====================================================================================================================
+//
+// 산출물 캐시 (입력 내용이 같으면 파일명.o, 파일명.trace를 다시 만들지 않음)
+//
+// =====================================================================================================================
 
-    char output_file[MAX_LINE_LENGTH];
-    char filename_without_extension[MAX_LINE_LENGTH];
-    sscanf(filename, "%[^.]", filename_without_extension);
-    snprintf(output_file, sizeof(output_file), "%s.o", filename_without_extension);
+typedef enum {
+    NO_CACHE,
+    CONTENT_CACHE, // 입력 내용의 hash로만 찾음 (daemon이 받은 소스처럼 경로가 의미 없는 입력)
+    PATH_AND_CONTENT_CACHE // 경로의 (크기, 수정 시각)이 기록과 같으면 내용을 다시 읽지 않음
+} Cache_Mode;
 
-    FILE *output = fopen(output_file, "w");
+typedef struct {
+    char hash[17]; // 입력 내용과 도구 버전의 64비트 FNV-1a hash (16진수)
+    long long size;
+    long long mtime_sec;
+    long mtime_nsec;
+} Cache_Key;
 
-    char line[MAX_LINE_LENGTH] = {0,};
-    int pc = STARTING_PC;
+// 같은 버전 번호라도 다시 빌드하면 다른 캐시를 쓰도록 빌드 시각을 함께 넣음
+const char *cache_tool_version = TOOL_VERSION " " __DATE__ " " __TIME__;
 
-    while (fgets(line, sizeof(line), input_file)) {
-        char instruction_name[MAX_LINE_LENGTH] = {0,};
-        char jump_label_name[MAX_LINE_LENGTH] = {0,};
-        char procedure_name[MAX_LINE_LENGTH] = {0,};
-        int rd = 0, rs1 = 0, rs2 = 0, imm = 0;
-        int machine_code = 0;
-
-        if (sscanf(line, "%s x%d, x%d, x%d", instruction_name, &rd, &rs1, &rs2) == 4) {
-            const R_Instruction *r_instr = find_r_instruction(instruction_name);
-            machine_code = encode_r_type(r_instr->funct7, rs2, rs1, r_instr->funct3, rd, r_instr->opcode);
-        }
-
-        // operation rd, rs1, imm12 format instruction -> I type with immediate instruction
-        // operation rd, rs1, shamt format instruction -> SLLI & SRLI & SRAI instruction only
-        // I 타입 명령어 처리 - immediate 값을 사용하는 경우
-        else if (sscanf(line, "%s x%d, x%d, %d", instruction_name, &rd, &rs1, &imm) == 4) {
-            const I_Instruction *i_instr = find_i_instruction(instruction_name);
-
-            if (strcasecmp(instruction_name, "SLLI") == 0 ||
-                strcasecmp(instruction_name, "SRLI") == 0 ||
-                strcasecmp(instruction_name, "SRAI") == 0) {
-                int shamt = imm;
-                machine_code = encode_i_type(
-                    (i_instr->funct7 << 5) | shamt,
-                    rs1,
-                    i_instr->funct3,
-                    rd,
-                    i_instr->opcode
-                );
-            } else {
-                machine_code = encode_i_type(imm, rs1, i_instr->funct3, rd, i_instr->opcode);
-            }
-        }
+uint64_t fnv1a_hash(uint64_t hash, const void *data, const size_t size) {
+    const uint8_t *bytes = data;
+
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ULL;
+    }
 
+    return hash;
+}
 
-        // operation rd, imm12(rs1) format instruction -> I type with load instruction
-        // operation rs2, imm12(rs1) format instruction -> S type with store instruction
-        // JALR x0, 0(x1) format instruction -> I type with jump and link instruction
-        else if (sscanf(line, "%s x%d, %d(x%d)", instruction_name, &rd, &imm, &rs1) == 4) {
-            int is_LW = strcasecmp(instruction_name, "LW"); // compare does instruction is LW
-            int is_JARL = strcasecmp(instruction_name, "JALR");
+int stat_cache_input(const char *filename, Cache_Key *key) {
+    struct stat info;
 
-            if (is_LW == 0) {
-                const I_Instruction *i_instr = find_i_instruction(instruction_name); // return only LW instruction
-                machine_code = encode_i_type(imm, rs1, i_instr->funct3, rd, i_instr->opcode);
-            } else if (is_JARL == 0) {
-                const I_Instruction *i_instr = find_i_instruction(instruction_name);
-                machine_code = encode_i_type(imm, rs1, i_instr->funct3, rd, i_instr->opcode);
-            } else {
-                // SW case
-                const S_Instruction *s_instr = find_s_instruction(instruction_name); // return only SW instruction
+    if (stat(filename, &info) != 0) {
+        return 0;
+    }
+
+    key->size = (long long) info.st_size;
+    key->mtime_sec = (long long) info.st_mtim.tv_sec;
+    key->mtime_nsec = info.st_mtim.tv_nsec;
+    return 1;
+}
 
-                int imm1; // imm[11:5]
-                int imm2; // imm[4:0]
+// 입력 파일 경로마다 마지막으로 본 (크기, 수정 시각)과 hash를 기록해 두는 파일
+void make_cache_index_path(const char *filename, char *path, const size_t size) {
+    const uint64_t path_hash = fnv1a_hash(0xCBF29CE484222325ULL, filename, strlen(filename));
+    snprintf(path, size, "%s/path-%016llx", CACHE_DIRECTORY, (unsigned long long) path_hash);
+}
 
-                parse_imm_for_s_type_inst(imm, &imm1, &imm2); // parse imm into two individual imm variables
+// PATH_AND_CONTENT_CACHE에서 (크기, 수정 시각)이 기록과 같으면 기록된 hash를 쓰고, 아니면 파일 내용을 읽어 hash를 계산
+int compute_cache_key(const char *filename, const Cache_Mode mode, Cache_Key *key) {
+    char index_path[MAX_LINE_LENGTH + 32] = {0,};
+    char recorded_path[MAX_LINE_LENGTH + 2] = {0,};
+    char recorded_version[64] = {0,};
+    Cache_Key recorded = {{0,}, 0, 0, 0};
 
-                rs2 = rd; // SW instruction doesn't use rd. Change into rs2.
+    if (!stat_cache_input(filename, key)) {
+        return 0;
+    }
 
-                machine_code = encode_s_type(imm1, rs2, rs1, s_instr->funct3, imm2, s_instr->opcode);
-            }
+    make_cache_index_path(filename, index_path, sizeof(index_path));
+    FILE *index = mode == PATH_AND_CONTENT_CACHE ? fopen(index_path, "r") : NULL;
+
+    if (index != NULL) {
+        const int matched = fscanf(index, "%lld %lld %ld %16s ", &recorded.size, &recorded.mtime_sec,
+                                   &recorded.mtime_nsec, recorded.hash) == 4
+                            && fgets(recorded_path, sizeof(recorded_path), index) != NULL
+                            && fgets(recorded_version, sizeof(recorded_version), index) != NULL;
+        fclose(index);
+
+        // 기록된 hash에는 기록할 때의 도구 버전이 들어 있으므로 버전이 다르면 내용을 다시 읽어 hash를 계산
+        recorded_path[strcspn(recorded_path, "\n")] = '\0';
+        recorded_version[strcspn(recorded_version, "\n")] = '\0';
+        if (matched && strcmp(recorded_path, filename) == 0 && strcmp(recorded_version, cache_tool_version) == 0
+            && recorded.size == key->size
+            && recorded.mtime_sec == key->mtime_sec && recorded.mtime_nsec == key->mtime_nsec) {
+            memcpy(key->hash, recorded.hash, sizeof(key->hash));
+            return 1;
         }
+    }
 
-        // operation rs1, rs2, imm12 format instruction -> SB type
-        else if (sscanf(line, "%s x%d, x%d, %s", instruction_name, &rs1, &rs2, jump_label_name) == 4) {
-            const SB_Instruction *sb_instr = find_sb_instruction(instruction_name);
+    FILE *input_file = fopen(filename, "rb");
+    uint8_t buffer[4096];
+    size_t read_size;
+    uint64_t hash = fnv1a_hash(0xCBF29CE484222325ULL, cache_tool_version, strlen(cache_tool_version) + 1);
 
-            const int labels_size = sizeof(labels) / sizeof(labels[0]);
-            for (int i = 0; i < labels_size; i++) {
-                if (strcasecmp(labels[i].name, jump_label_name) == 0) {
-                    imm = labels[i].pc_address - pc;
-                    break;
-                }
-            }
+    if (input_file == NULL) {
+        return 0;
+    }
+    while ((read_size = fread(buffer, 1, sizeof(buffer), input_file)) > 0) {
+        hash = fnv1a_hash(hash, buffer, read_size);
+    }
+    fclose(input_file);
+
+    snprintf(key->hash, sizeof(key->hash), "%016llx", (unsigned long long) hash);
+    return 1;
+}
+
+// source를 destination으로 hardlink하고, 다른 파일 시스템이라 실패하면 복사
+int link_or_copy_file(const char *source, const char *destination) {
+    remove(destination);
+
+    if (link(source, destination) == 0) {
+        return 1;
+    }
+
+    FILE *input = fopen(source, "rb");
+    if (input == NULL) {
+        return 0;
+    }
+    FILE *output = fopen(destination, "wb");
+    if (output == NULL) {
+        fclose(input);
+        return 0;
+    }
+
+    char buffer[4096];
+    size_t read_size;
+    while ((read_size = fread(buffer, 1, sizeof(buffer), input)) > 0) {
+        fwrite(buffer, 1, read_size, output);
+    }
 
-            int imm1; // imm[12:10-5]
-            int imm2; // imm[4-0:11]
+    fclose(input);
+    return fclose(output) == 0;
+}
+
+const char *cached_extensions[] = {".o", ".trace"};
 
-            parse_imm_for_sb_type_inst(imm, &imm1, &imm2);
+// 캐시에 같은 hash의 결과가 있으면 파일명.o, 파일명.trace로 가져오고, 실행할 때 출력했던 오류 메시지를 다시 출력한 뒤 1을 반환
+int restore_cached_outputs(const char *filename, const Cache_Key *key) {
+    char log_path[64] = {0,};
+    snprintf(log_path, sizeof(log_path), "%s/%s.log", CACHE_DIRECTORY, key->hash);
 
-            machine_code = encode_sb_type(imm1, rs2, rs1, sb_instr->funct3, imm2, sb_instr->opcode);
+    // .log는 마지막에 저장되므로 .log가 있으면 .o, .trace도 완성되어 있음
+    FILE *log = fopen(log_path, "r");
+    if (log == NULL) {
+        return 0;
+    }
+    runtime_diagnostics_length = fread(runtime_diagnostics, 1, sizeof(runtime_diagnostics) - 1, log);
+    runtime_diagnostics[runtime_diagnostics_length] = '\0';
+    fclose(log);
+
+    for (int i = 0; i < 2; i++) {
+        char cache_path[64] = {0,};
+        char output_path[MAX_LINE_LENGTH + 8] = {0,};
+        snprintf(cache_path, sizeof(cache_path), "%s/%s%s", CACHE_DIRECTORY, key->hash, cached_extensions[i]);
+        make_output_filename(filename, cached_extensions[i], output_path, sizeof(output_path));
+
+        if (!link_or_copy_file(cache_path, output_path)) {
+            clear_runtime_diagnostics();
+            return 0;
         }
+    }
 
-        // operation rd, imm20 format instruction -> UJ type
-        else if (sscanf(line, "%s x%d, %s", instruction_name, &rd, procedure_name) == 3) {
-            const UJ_Instruction *uj_instr = find_uj_instruction(instruction_name);
+    printf("%s", runtime_diagnostics);
+    return 1;
+}
 
-            const int labels_size = sizeof(labels) / sizeof(labels[0]);
-            for (int i = 0; i < labels_size; i++) {
-                if (strcasecmp(labels[i].name, procedure_name) == 0) {
-                    imm = labels[i].pc_address - pc;
-                    break;
-                }
-            }
+// 새로 만든 파일명.o, 파일명.trace와 실행 중 출력한 오류 메시지(.log)를 캐시에 넣고
+// PATH_AND_CONTENT_CACHE이면 입력 파일의 (크기, 수정 시각)을 기록
+// 실행하는 동안 입력 파일이 바뀌었거나 오류 메시지를 다 모으지 못했으면 다시 보여줄 수 없으므로 저장하지 않음
+void store_cached_outputs(const char *filename, const Cache_Key *key, const Cache_Mode mode) {
+    Cache_Key current;
+
+    if (runtime_diagnostics_truncated || !stat_cache_input(filename, &current) || current.size != key->size || current.mtime_sec != key->mtime_sec
+        || current.mtime_nsec != key->mtime_nsec) {
+        return;
+    }
+    if (mkdir(CACHE_DIRECTORY, 0755) != 0 && errno != EEXIST) {
+        return;
+    }
 
-            imm = parse_imm_for_uj_type_inst(imm);
+    // 다른 프로세스가 같은 항목을 동시에 쓰더라도 완성된 파일만 보이도록 임시 이름으로 만든 뒤 rename
+    for (int i = 0; i < 2; i++) {
+        char output_path[MAX_LINE_LENGTH + 8] = {0,};
+        char temporary_path[96] = {0,};
+        char cache_path[64] = {0,};
 
-            machine_code = encode_uj_type(imm, rd, uj_instr->opcode);
+        make_output_filename(filename, cached_extensions[i], output_path, sizeof(output_path));
+        snprintf(temporary_path, sizeof(temporary_path), "%s/tmp-%ld-%s%s", CACHE_DIRECTORY, (long) getpid(),
+                 key->hash, cached_extensions[i]);
+        snprintf(cache_path, sizeof(cache_path), "%s/%s%s", CACHE_DIRECTORY, key->hash, cached_extensions[i]);
+
+        if (!link_or_copy_file(output_path, temporary_path) || rename(temporary_path, cache_path) != 0) {
+            remove(temporary_path);
+            return;
         }
+    }
 
-        // EXIT
-        else if (sscanf(line, "%s", instruction_name) == 1) {
-            if (strcasecmp(instruction_name, "EXIT") == 0) {
-                machine_code = EXIT_CODE;
-            } else {
-                continue;
-            }
+    char log_path[64] = {0,};
+    char temporary_log_path[96] = {0,};
+    snprintf(log_path, sizeof(log_path), "%s/%s.log", CACHE_DIRECTORY, key->hash);
+    snprintf(temporary_log_path, sizeof(temporary_log_path), "%s/tmp-%ld-%s.log", CACHE_DIRECTORY, (long) getpid(),
+             key->hash);
+
+    FILE *log = fopen(temporary_log_path, "w");
+    if (log == NULL) {
+        return;
+    }
+    fwrite(runtime_diagnostics, 1, runtime_diagnostics_length, log);
+    if (fclose(log) != 0 || rename(temporary_log_path, log_path) != 0) {
+        remove(temporary_log_path);
+        return;
+    }
+
+    if (mode != PATH_AND_CONTENT_CACHE) {
+        return;
+    }
+
+    char index_path[MAX_LINE_LENGTH + 32] = {0,};
+    char temporary_path[MAX_LINE_LENGTH + 64] = {0,};
+    make_cache_index_path(filename, index_path, sizeof(index_path));
+    snprintf(temporary_path, sizeof(temporary_path), "%s.tmp-%ld", index_path, (long) getpid());
+
+    FILE *index = fopen(temporary_path, "w");
+    if (index == NULL) {
+        return;
+    }
+    fprintf(index, "%lld %lld %ld %s\n%s\n%s\n", key->size, key->mtime_sec, key->mtime_nsec, key->hash, filename,
+            cache_tool_version);
+    fclose(index);
+    rename(temporary_path, index_path);
+}
+
+// 입력 파일을 파일명.o로 변환하고 with_trace이면 실행하여 파일명.trace도 생성. 캐시에 같은 입력의 결과가 있으면 가져옴
+// 성공하면 NULL을, 실패하면 사용자에게 보여줄 메시지를 반환
+const char *assemble_input_file(const char *filename, const bool with_trace, const Cache_Mode cache_mode) {
+    FILE *input_file = fopen(filename, "r");
+
+    if (!input_file) {
+        return "Input file does not exist!!";
+    }
+    fclose(input_file);
+
+    clear_runtime_diagnostics();
+
+    Cache_Key cache_key;
+    const bool has_cache_key = with_trace && cache_mode != NO_CACHE
+                               && compute_cache_key(filename, cache_mode, &cache_key);
+
+    if (has_cache_key && restore_cached_outputs(filename, &cache_key)) {
+        return NULL;
+    }
+
+    memset(stage_seconds, 0, sizeof(stage_seconds));
+
+    double start = monotonic_seconds();
+    const int syntax_error_flag = have_syntax_error_instruction(filename, DATA_SEGMENT_ADDRESS);
+    record_stage(PARSE_STAGE, start);
+
+    if (syntax_error_flag) {
+        return "Syntax Error!!";
+    }
+
+    start = monotonic_seconds();
+    const int label_error_flag = record_label();
+    record_stage(LABEL_STAGE, start);
+
+    if (label_error_flag) {
+        return "Syntax Error!!";
+    }
+
+    start = monotonic_seconds();
+    translate_assembly_instruction(filename);
+    record_stage(TRANSLATE_STAGE, start);
+
+    if (with_trace) {
+        start = monotonic_seconds();
+        trace_pc(filename);
+        record_stage(TRACE_STAGE, start);
+
+        // 끝까지 실행하지 못한 결과는 캐시에 저장하지 않음
+        if (step_limit_exceeded) {
+            return "Step limit exceeded";
         }
 
-        // rest of the case. might be blank line and label
-        else {
-            continue;
+        if (has_cache_key) {
+            store_cached_outputs(filename, &cache_key, cache_mode);
         }
+    }
 
-        // Write machine code in output file
-        if (machine_code == EXIT_CODE) {
-            print_binary_to_file(EXIT_CODE, output);
-        } else {
-            print_binary_to_file(machine_code, output);
+    return NULL;
+}
+
+const char *instruction_type_names[] = {"R", "I", "S", "SB", "U", "UJ", "EXIT"};
+
+// 파일명.metrics.json 생성. 단계별 시간, 형식별 실행 명령어 수, hardware counter를 기록
+void write_metrics_file(const char *filename) {
+    char metrics_file[MAX_LINE_LENGTH + 16] = {0,};
+    long long executed_by_type[EXIT_TYPE + 1] = {0,};
+    long long executed_count = 0;
+    double total_seconds = 0;
+
+    for (int i = 0; i < instruction_count; i++) {
+        executed_by_type[program[i].type] += execution_counts[i];
+        executed_count += execution_counts[i];
+    }
+
+    make_output_filename(filename, ".metrics.json", metrics_file, sizeof(metrics_file));
+    FILE *metrics = fopen(metrics_file, "w");
+
+    fprintf(metrics, "{\n  \"file\": ");
+    fprintf_json_string(metrics, filename);
+    fprintf(metrics, ",\n  \"tool_version\": \"%s\",\n  \"timestamp\": %lld,\n", TOOL_VERSION, (long long) time(NULL));
+
+    fprintf(metrics, "  \"stages_seconds\": {");
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        fprintf(metrics, "%s\n    \"%s\": %.9f", stage == 0 ? "" : ",", stage_names[stage], stage_seconds[stage]);
+        total_seconds += stage_seconds[stage];
+    }
+    fprintf(metrics, ",\n    \"total\": %.9f\n  },\n", total_seconds);
+
+    fprintf(metrics, "  \"instruction_count\": %d,\n  \"executed\": {\n    \"total\": %lld", instruction_count,
+            executed_count);
+    for (int type = R_TYPE; type <= EXIT_TYPE; type++) {
+        fprintf(metrics, ",\n    \"%s\": %lld", instruction_type_names[type], executed_by_type[type]);
+    }
+    fprintf(metrics, "\n  },\n");
+
+    // trace_pc는 trace 파일 쓰기를 포함하므로 이 값은 trace를 만드는 속도임
+    fprintf(metrics, "  \"executed_per_second\": %.1f,\n",
+            stage_seconds[TRACE_STAGE] > 0 ? (double) executed_count / stage_seconds[TRACE_STAGE] : 0.0);
 
-            pc += 4; // Increment PC by 4 for each instruction
+    fprintf(metrics, "  \"perf\": ");
+    if (!perf_counters_enabled) {
+        fprintf(metrics, "null\n}\n");
+    } else {
+        fprintf(metrics, "{");
+        for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+            fprintf(metrics, "%s\n    \"%s\": ", i == 0 ? "" : ",", perf_counter_names[i]);
+            if (perf_counts[i] < 0) {
+                fprintf(metrics, "null");
+            } else {
+                fprintf(metrics, "%lld", perf_counts[i]);
+            }
         }
+        fprintf(metrics, "\n  }\n}\n");
     }
 
-    fclose(input_file);
-    fclose(output);
+    fclose(metrics);
+}
 
-    // printf("Files %s generated successfully.\n", output_file);
+// =====================================================================================================================
+//
+// Daemon 모드 (Unix domain socket으로 요청을 받아 worker process에서 처리)
+//
+// =====================================================================================================================
+//
+// 요청은 한 줄의 header로 시작하며 한 연결에서 여러 요청을 차례로 보낼 수 있음
+//   PATH <파일명> [--data] [--no-cache]   : daemon의 작업 디렉터리 기준 파일을 변환, 실행
+//   SOURCE <바이트 수> [--no-cache]        : header 다음에 오는 소스를 변환, 실행 (결과는 항상 내용으로 보냄)
+// 응답
+//   OK 또는 ERROR <메시지> (예: ERROR Syntax Error!!, 실행 명령어 수가 --max-steps를 넘으면 ERROR Step limit exceeded)
+//   DIAGNOSTIC <메시지>                  : 실행 중 출력한 오류 메시지 (예: Memory access error: ...), 한 줄에 하나
+//   OBJECT <경로>, TRACE <경로>           : 파일을 만든 위치
+//   OBJECT <바이트 수>\n<내용>, TRACE ...   : --data이거나 SOURCE 요청일 때
+//   END
+
+volatile sig_atomic_t stop_requested = 0;
+
+void request_stop(const int signal_number) {
+    (void) signal_number;
+    stop_requested = 1;
 }
 
-void trace_pc(const char *filename) {
-    FILE *input_file = fopen(filename, "r");
+// SA_RESTART 없이 등록하여 accept, read가 signal에 깨어나도록 함
+void install_stop_handler(void) {
+    struct sigaction action;
 
-    char trace_file[MAX_LINE_LENGTH] = {0,};
-    char filename_without_extension[MAX_LINE_LENGTH] = {0,};
-    sscanf(filename, "%[^.]", filename_without_extension);
-    snprintf(trace_file, sizeof(trace_file), "%s.trace", filename_without_extension);
-    FILE *trace = fopen(trace_file, "w");
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = request_stop;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+}
 
-    char line[MAX_LINE_LENGTH] = {0,};
-    int pc = STARTING_PC;
+int send_file_contents(FILE *output, const char *kind, const char *path) {
+    FILE *file = fopen(path, "rb");
+    char buffer[4096];
+    size_t read_size;
 
-    char instructions[MAX_LINE_COUNT][MAX_LINE_LENGTH] = {{0,}};
+    if (file == NULL || fseek(file, 0, SEEK_END) != 0) {
+        if (file != NULL) fclose(file);
+        return 0;
+    }
 
-    int index = 0;
-    while (fgets(line, sizeof(line), input_file)) {
-        if (line[0] == '\n') {
-            continue;
+    fprintf(output, "%s %ld\n", kind, ftell(file));
+    rewind(file);
+    while ((read_size = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        fwrite(buffer, 1, read_size, output);
+    }
+
+    fclose(file);
+    return 1;
+}
+
+// header 뒤의 size 바이트를 path에 씀. 연결이 끊겨 다 받지 못하면 0을 반환
+int receive_source(FILE *input, const long size, const char *path) {
+    FILE *source_file = fopen(path, "wb");
+    char buffer[4096];
+    long remaining = size;
+
+    if (source_file == NULL) {
+        return 0;
+    }
+
+    while (remaining > 0) {
+        const size_t chunk = remaining < (long) sizeof(buffer) ? (size_t) remaining : sizeof(buffer);
+        const size_t read_size = fread(buffer, 1, chunk, input);
+
+        if (read_size == 0) {
+            break;
         }
-        strcpy(instructions[index], line);
-        index++;
+        fwrite(buffer, 1, read_size, source_file);
+        remaining -= (long) read_size;
     }
 
-    for (int pc_location = 0; pc_location < index;) {
-        char instruction_name[MAX_LINE_LENGTH] = {0,};
-        char jump_label_name[MAX_LINE_LENGTH] = {0,};
-        char procedure_name[MAX_LINE_LENGTH] = {0,};
-        int rd = 0, rs1 = 0, rs2 = 0, imm = 0;
+    fclose(source_file);
+    return remaining == 0;
+}
+
+// 요청 하나를 처리하고 응답을 씀. 연결을 더 사용할 수 없으면 0을 반환
+int handle_request(char *header, FILE *input, FILE *output, const char *work_directory,
+                   const Cache_Mode default_cache_mode) {
+    const char *command = strtok(header, " \t\r\n");
+    const char *argument = strtok(NULL, " \t\r\n");
+    Cache_Mode cache_mode = default_cache_mode;
+    bool send_data = false;
+    char filename[MAX_LINE_LENGTH] = {0,};
+
+    if (command == NULL) {
+        return 1; // 빈 줄은 무시
+    }
 
-        strcpy(line, instructions[pc_location]);
+    for (const char *option = strtok(NULL, " \t\r\n"); option != NULL; option = strtok(NULL, " \t\r\n")) {
+        if (strcmp(option, "--no-cache") == 0) {
+            cache_mode = NO_CACHE;
+        } else if (strcmp(option, "--data") == 0) {
+            send_data = true;
+        } else {
+            fprintf(output, "ERROR Unknown option: %s\nEND\n", option);
+            return strcmp(command, "SOURCE") != 0; // 뒤따르는 소스를 건너뛸 수 없으므로 연결을 닫음
+        }
+    }
 
-        // Execute R type instruction
-        if (sscanf(line, "%s x%d, x%d, x%d", instruction_name, &rd, &rs1, &rs2) == 4) {
-            const R_Instruction *r_instr = find_r_instruction(instruction_name);
-            execute_r_type(r_instr, rd, rs1, rs2, trace, &pc, &pc_location);
+    if (strcmp(command, "PATH") == 0 && argument != NULL) {
+        if (strlen(argument) >= sizeof(filename)) {
+            fprintf(output, "ERROR File name too long\nEND\n");
+            return 1;
+        }
+        strcpy(filename, argument);
+    } else if (strcmp(command, "SOURCE") == 0 && argument != NULL) {
+        char *end_ptr;
+        const long size = strtol(argument, &end_ptr, 10);
+
+        if (*end_ptr != '\0' || size < 0 || size > MAX_SOURCE_SIZE) {
+            fprintf(output, "ERROR Invalid source size\nEND\n");
+            return 0;
         }
 
-        // Execute "operation rd, rs1, imm12" format instruction
-        // Execute "operation rd, rs1, shamt" format instruction
-        else if (sscanf(line, "%s x%d, x%d, %d", instruction_name, &rd, &rs1, &imm) == 4) {
-            const I_Instruction *i_instr = find_i_instruction(instruction_name);
+        snprintf(filename, sizeof(filename), "%s/job.s", work_directory);
+        if (!receive_source(input, size, filename)) {
+            return 0;
+        }
 
-            if (strcasecmp(instruction_name, "SLLI") == 0 ||
-                strcasecmp(instruction_name, "SRLI") == 0 ||
-                strcasecmp(instruction_name, "SRAI") == 0) {
-                int shamt = imm;
-                execute_i_type(i_instr, rd, rs1, shamt, trace, &pc, &pc_location); // Execute SLLI & SRLI & SRAI
-            } else {
-                execute_i_type(i_instr, rd, rs1, imm, trace, &pc, &pc_location); // Execute ADDI, XORI, ORI, ANDI
-            }
+        send_data = true;
+        if (cache_mode == PATH_AND_CONTENT_CACHE) {
+            cache_mode = CONTENT_CACHE; // 매번 같은 경로에 쓰므로 (크기, 수정 시각)으로는 구분할 수 없음
         }
+    } else {
+        fprintf(output, "ERROR Unknown request\nEND\n");
+        return 1;
+    }
 
-        // Execute "operation rd, imm12(rs1)" format instruction
-        // Execute "operation rs2, imm12(rs1)" format instruction
-        // Execute "JALR x0, 0(x1)" format instruction
-        else if (sscanf(line, "%s x%d, %d(x%d)", instruction_name, &rd, &imm, &rs1) == 4) {
-            int is_LW = strcasecmp(instruction_name, "LW"); // compare does instruction is LW
-            int is_JARL = strcasecmp(instruction_name, "JALR");
+    initialize_registers();
+    initialize_memory();
 
-            const I_Instruction *i_instr = find_i_instruction(instruction_name);
+    const char *error_message = assemble_input_file(filename, true, cache_mode);
 
-            if (is_LW == 0) {
-                execute_i_type(i_instr, rd, rs1, imm, trace, &pc, &pc_location);
-            } else if (is_JARL == 0) {
-                execute_i_type(i_instr, rd, rs1, imm, trace, &pc, &pc_location);
-            } else {
-                // SW case
-                const S_Instruction *s_instr = find_s_instruction(instruction_name); // return only SW instruction
-                rs2 = rd; // SW instruction doesn't use rd. Change into rs2.
-                execute_s_type(s_instr, rs2, rs1, imm, trace, &pc, &pc_location);
-            }
+    if (error_message != NULL) {
+        fprintf(output, "ERROR %s\n", error_message);
+    } else {
+        char object_file[MAX_LINE_LENGTH + 8] = {0,};
+        char trace_file[MAX_LINE_LENGTH + 8] = {0,};
+        make_output_filename(filename, ".o", object_file, sizeof(object_file));
+        make_output_filename(filename, ".trace", trace_file, sizeof(trace_file));
+
+        fprintf(output, "OK\n");
+
+        // 실행 중 출력한 오류 메시지를 한 줄씩 보냄
+        for (const char *line = runtime_diagnostics; *line != '\0';) {
+            const size_t length = strcspn(line, "\n");
+            fprintf(output, "DIAGNOSTIC %.*s\n", (int) length, line);
+            line += length + (line[length] == '\n');
         }
 
-        // Execute "operation rs1, rs2, imm12" format instruction
-        else if (sscanf(line, "%s x%d, x%d, %s", instruction_name, &rs1, &rs2, jump_label_name) == 4) {
-            const SB_Instruction *sb_instr = find_sb_instruction(instruction_name);
+        if (send_data) {
+            send_file_contents(output, "OBJECT", object_file);
+            send_file_contents(output, "TRACE", trace_file);
+        } else {
+            fprintf(output, "OBJECT %s\nTRACE %s\n", object_file, trace_file);
+        }
+    }
+    fprintf(output, "END\n");
+
+    if (strcmp(command, "SOURCE") == 0) {
+        char path[MAX_LINE_LENGTH + 8] = {0,};
+        remove(filename);
+        make_output_filename(filename, ".o", path, sizeof(path));
+        remove(path);
+        make_output_filename(filename, ".trace", path, sizeof(path));
+        remove(path);
+    }
+
+    return 1;
+}
 
-            const int labels_size = sizeof(labels) / sizeof(labels[0]);
-            for (int i = 0; i < labels_size; i++) {
-                if (strcasecmp(labels[i].name, jump_label_name) == 0) {
-                    imm = labels[i].pc_address - pc;
-                    break;
-                }
-            }
+void serve_connection(const int connection, const char *work_directory, const Cache_Mode cache_mode) {
+    FILE *input = fdopen(dup(connection), "r");
+    FILE *output = fdopen(connection, "w");
+    char header[MAX_SOURCE_LINE_LENGTH] = {0,};
 
-            execute_sb_type(sb_instr, rs1, rs2, imm, trace, &pc, &pc_location);
+    while (!stop_requested && fgets(header, sizeof(header), input) != NULL) {
+        const int keep_open = handle_request(header, input, output, work_directory, cache_mode);
+
+        if (fflush(output) != 0 || !keep_open) {
+            break;
         }
+    }
+
+    fclose(input);
+    fclose(output);
+}
 
-        // Execute "operation rd, imm20" format instruction
-        else if (sscanf(line, "%s x%d, %s", instruction_name, &rd, procedure_name) == 3) {
-            const UJ_Instruction *uj_instr = find_uj_instruction(instruction_name);
+// worker process는 종료될 때까지 같은 socket에서 연결을 받아 차례로 처리함
+// 명령어 table, 캐시 index 등 process 상태는 요청 사이에 그대로 유지됨
+void run_worker(const int server, const Cache_Mode cache_mode) {
+    char work_directory[] = "/tmp/rvd-XXXXXX"; // SOURCE 요청의 소스와 결과를 잠시 두는 곳
 
-            const int labels_size = sizeof(labels) / sizeof(labels[0]);
-            for (int i = 0; i < labels_size; i++) {
-                if (strcasecmp(labels[i].name, procedure_name) == 0) {
-                    imm = labels[i].pc_address - pc;
-                    break;
-                }
-            }
+    signal(SIGPIPE, SIG_IGN);
+    install_stop_handler();
 
-            execute_uj_type(uj_instr, rd, imm, trace, &pc, &pc_location);
+    if (mkdtemp(work_directory) == NULL) {
+        return;
+    }
+
+    while (!stop_requested) {
+        const int connection = accept(server, NULL, NULL);
+
+        if (connection < 0) {
+            continue;
         }
 
-        // EXIT
-        else if (sscanf(line, "%s", instruction_name) == 1) {
-            if (strcasecmp(instruction_name, "EXIT") == 0) {
-                fprintf_pc_into_trace_file(trace, &pc);
-                fclose(trace);
-                return;
-            }
+        serve_connection(connection, work_directory, cache_mode);
+    }
+
+    rmdir(work_directory);
+}
+
+pid_t start_worker(const int server, const Cache_Mode cache_mode) {
+    const pid_t pid = fork();
+
+    if (pid == 0) {
+        run_worker(server, cache_mode);
+        _exit(0);
+    }
+
+    return pid;
+}
+
+// socket_path에서 요청을 받는 worker process를 worker_count개 띄우고, SIGINT/SIGTERM을 받을 때까지 죽은 worker를 다시 띄움
+int run_server(const char *socket_path, const int worker_count, const Cache_Mode cache_mode) {
+    struct sockaddr_un address;
+    pid_t workers[MAX_WORKER_COUNT];
+
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(address.sun_path)) {
+        printf("Socket path too long: %s\n", socket_path);
+        return 1;
+    }
+    strcpy(address.sun_path, socket_path);
+
+    const int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socket_path);
+    if (server < 0 || bind(server, (struct sockaddr *) &address, sizeof(address)) != 0 || listen(server, 64) != 0) {
+        printf("Cannot listen on %s: %s\n", socket_path, strerror(errno));
+        return 1;
+    }
+
+    install_stop_handler();
+    fflush(stdout);
+
+    for (int i = 0; i < worker_count; i++) {
+        workers[i] = start_worker(server, cache_mode);
+    }
+
+    while (!stop_requested) {
+        const pid_t pid = waitpid(-1, NULL, 0);
 
-            pc_location++;
+        for (int i = 0; i < worker_count && pid > 0 && !stop_requested; i++) {
+            if (workers[i] == pid) {
+                workers[i] = start_worker(server, cache_mode);
+            }
         }
     }
 
-    fclose(trace);
+    for (int i = 0; i < worker_count; i++) {
+        if (workers[i] > 0) {
+            kill(workers[i], SIGTERM);
+        }
+    }
+    while (waitpid(-1, NULL, 0) > 0 || errno == EINTR) {
+    }
 
-    // printf("Files %s generated successfully.\n", trace_file);
+    close(server);
+    unlink(socket_path);
+    return 0;
 }
 
 // =====================================================================================================================
@@ -857,14 +3717,129 @@ void trace_pc(const char *filename) {
 //
 // =====================================================================================================================
 
-int main() {
+int main(int argc, char *argv[]) {
     int terminate_flag = 0;
+    Optimize_Mode optimize_mode = NO_OPTIMIZATION;
+    bool export_dot = false;
+    bool export_json = false;
+    int hart_count = 0;
+    Schedule_Mode schedule_mode = ROUND_ROBIN_SCHEDULE;
+    bool batch_mode = false;
+    Cache_Mode cache_mode = PATH_AND_CONTENT_CACHE;
+    const char *socket_path = NULL;
+    int worker_count = 4;
+    long long step_limit = -1; // --max-steps를 주지 않으면 daemon 모드에서만 DEFAULT_DAEMON_MAX_STEPS를 사용
+    bool write_metrics = false;
+
+    // --optimize=report: 파일명.opt.report만 생성
+    // --optimize=run: 파일명.opt.report와 함께 최적화된 프로그램의 파일명.opt.o, 파일명.opt.trace 생성
+    // --cfg=dot, --cfg=json: 실행 횟수를 포함한 CFG를 파일명.cfg.dot, 파일명.cfg.json으로 생성
+    // --harts=N: 입력 파일을 메모리를 공유하는 N개의 hart에서 실행하고 hart마다 파일명.hart<i>.trace 생성
+    // --schedule=round-robin, --schedule=threads: hart를 명령어 단위로 번갈아 실행할지, host 스레드에서 실행할지
+    // --batch=상태파일: 상태 파일의 줄마다 초기 register 값을 바꿔 실행하고 lane마다 파일명.lane<i>.trace, .regs 생성
+    // --no-cache: 입력 내용이 같아도 캐시(.rvcache)를 쓰지 않고 다시 변환, 실행
+    // --serve=socket경로, --workers=N: 표준 입력 대신 Unix domain socket으로 요청을 받아 N개의 worker process에서 처리
+    // --max-steps=N: 파일마다 명령어를 N개까지만 실행하고 넘으면 오류로 처리 (0이면 제한 없음)
+    // --metrics: 단계별 시간과 형식별 실행 명령어 수를 파일명.metrics.json으로 생성
+    // --metrics=perf: 여기에 실행 루프의 hardware counter(perf_event)를 함께 기록
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--optimize=report") == 0) {
+            optimize_mode = OPTIMIZE_REPORT;
+        } else if (strcmp(argv[i], "--optimize=run") == 0) {
+            optimize_mode = OPTIMIZE_RUN;
+        } else if (strcmp(argv[i], "--cfg=dot") == 0) {
+            export_dot = true;
+        } else if (strcmp(argv[i], "--cfg=json") == 0) {
+            export_json = true;
+        } else if (strncmp(argv[i], "--harts=", 8) == 0) {
+            char *end_ptr;
+            hart_count = (int) strtol(argv[i] + 8, &end_ptr, 10);
+            if (*end_ptr != '\0' || hart_count < 1 || hart_count > MAX_HART_COUNT) {
+                printf("Invalid hart count: %s (1 ~ %d)\n", argv[i] + 8, MAX_HART_COUNT);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--schedule=round-robin") == 0) {
+            schedule_mode = ROUND_ROBIN_SCHEDULE;
+        } else if (strcmp(argv[i], "--schedule=threads") == 0) {
+            schedule_mode = THREAD_SCHEDULE;
+        } else if (strncmp(argv[i], "--batch=", 8) == 0) {
+            if (!load_batch_states(argv[i] + 8)) {
+                return 1;
+            }
+            batch_mode = true;
+        } else if (strcmp(argv[i], "--no-cache") == 0) {
+            cache_mode = NO_CACHE;
+        } else if (strcmp(argv[i], "--metrics") == 0) {
+            write_metrics = true;
+        } else if (strcmp(argv[i], "--metrics=perf") == 0) {
+            write_metrics = true;
+            perf_counters_enabled = true;
+        } else if (strncmp(argv[i], "--serve=", 8) == 0) {
+            socket_path = argv[i] + 8;
+        } else if (strncmp(argv[i], "--workers=", 10) == 0) {
+            char *end_ptr;
+            worker_count = (int) strtol(argv[i] + 10, &end_ptr, 10);
+            if (*end_ptr != '\0' || worker_count < 1 || worker_count > MAX_WORKER_COUNT) {
+                printf("Invalid worker count: %s (1 ~ %d)\n", argv[i] + 10, MAX_WORKER_COUNT);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--max-steps=", 12) == 0) {
+            char *end_ptr;
+            step_limit = strtoll(argv[i] + 12, &end_ptr, 10);
+            if (*end_ptr != '\0' || end_ptr == argv[i] + 12 || step_limit < 0) {
+                printf("Invalid step limit: %s\n", argv[i] + 12);
+                return 1;
+            }
+        } else {
+            printf("Unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // 최적화와 CFG 내보내기는 하나의 program[]을 실행한 결과를 사용함
+    if (hart_count > 0 && (optimize_mode != NO_OPTIMIZATION || export_dot || export_json)) {
+        printf("--harts cannot be combined with --optimize or --cfg\n");
+        return 1;
+    }
+    if (batch_mode && (hart_count > 0 || optimize_mode != NO_OPTIMIZATION || export_dot || export_json)) {
+        printf("--batch cannot be combined with --harts, --optimize or --cfg\n");
+        return 1;
+    }
+    if (write_metrics && (batch_mode || hart_count > 0 || socket_path != NULL)) {
+        printf("--metrics cannot be combined with --batch, --harts or --serve\n");
+        return 1;
+    }
+
+    // 최적화, CFG 내보내기, 측정은 실행 결과(program[], execution_counts[])가 필요하므로 캐시를 쓰지 않음
+    if (batch_mode || optimize_mode != NO_OPTIMIZATION || export_dot || export_json || write_metrics) {
+        cache_mode = NO_CACHE;
+    }
+
+    // daemon은 무한 루프인 요청 하나가 worker를 계속 붙잡지 않도록 기본으로 실행 명령어 수를 제한함
+    if (step_limit >= 0) {
+        max_steps = step_limit;
+    } else if (socket_path != NULL) {
+        max_steps = DEFAULT_DAEMON_MAX_STEPS;
+    }
+
+    if (socket_path != NULL) {
+        if (batch_mode || hart_count > 0 || optimize_mode != NO_OPTIMIZATION || export_dot || export_json) {
+            printf("--serve cannot be combined with --batch, --harts, --optimize or --cfg\n");
+            return 1;
+        }
+        return run_server(socket_path, worker_count, cache_mode);
+    }
 
     while (true) {
-        initialize_registers(); // Need to initialize everytime when filename entered
+        // Need to initialize everytime when filename entered
+        initialize_registers();
+        initialize_memory();
+
         char filename[MAX_LINE_LENGTH] = {0,};
         printf("Enter Input File Name: ");
-        scanf("%s", filename);
+        if (scanf("%49s", filename) != 1) {
+            break;
+        }
 
         terminate_flag = strcasecmp("terminate", filename);
 
@@ -872,21 +3847,36 @@ int main() {
             break;
         }
 
-        FILE *input_file = fopen(filename, "r");
+        if (hart_count > 0) {
+            run_harts(filename, hart_count, schedule_mode);
+            continue;
+        }
+
+        const char *error_message = assemble_input_file(filename, !batch_mode, cache_mode);
 
-        if (!input_file) {
-            printf("Input file does not exist!!\n");
+        if (error_message != NULL) {
+            printf("%s\n", error_message);
+            continue;
+        }
+
+        if (batch_mode) {
+            trace_batch(filename);
             continue;
         }
 
-        const int syntax_error_flag = have_syntax_error_instruction(filename);
+        if (write_metrics) {
+            write_metrics_file(filename);
+        }
 
-        if (syntax_error_flag == 1) {
-            printf("Syntax Error!!\n");
-        } else {
-            record_label(filename);
-            translate_assembly_instruction(filename);
-            trace_pc(filename);
+        if (export_dot) {
+            export_cfg_dot(filename);
+        }
+        if (export_json) {
+            export_cfg_json(filename);
+        }
+
+        if (optimize_mode != NO_OPTIMIZATION) {
+            optimize_program(filename, optimize_mode);
         }
     }
 
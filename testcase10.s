@@ -0,0 +1,46 @@
+LUI x7, 0x12345
+ADDI x7, x7, 0x678
+ADDI x8, x0, 256
+SW x7, 0(x8)
+LB x9, 0(x8)
+ADDI x10, x0, 0x78
+BNE x9, x10, FAIL
+LH x11, 2(x8)
+LUI x12, 0x1
+ADDI x12, x12, 0x234
+BNE x11, x12, FAIL
+ADDI x13, x0, -1
+SB x13, 4(x8)
+SH x13, 6(x8)
+LB x14, 4(x8)
+BNE x14, x13, FAIL
+LBU x15, 4(x8)
+ADDI x16, x0, 255
+BNE x15, x16, FAIL
+LHU x17, 6(x8)
+LH x18, 6(x8)
+BNE x18, x13, FAIL
+SRLI x19, x13, 16
+BNE x17, x19, FAIL
+LB x20, 5(x8)
+BNE x20, x0, FAIL
+SLT x21, x13, x0
+SLTU x22, x13, x0
+SLTI x23, x13, 0
+SLTIU x24, x1, -1
+ADD x25, x21, x23
+ADD x25, x25, x24
+SUB x25, x25, x22
+ADDI x26, x0, 3
+BNE x25, x26, FAIL
+BLTU x13, x1, FAIL
+BGEU x1, x13, FAIL
+BLTU x1, x13, NEXT
+JAL x0, FAIL
+NEXT: AUIPC x27, 0
+JAL x28, HERE
+HERE: ADDI x29, x27, 8
+BNE x28, x29, FAIL
+EXIT
+FAIL:
+EXIT
@@ -0,0 +1,55 @@
+# pseudo 명령어, ABI register 이름, .data / .word 지시어 테스트
+.data
+array: .word 10, 20, 30, -5
+count: .word 4
+
+.text
+main:
+    la a0, array            # a0 = array 주소
+    la t0, count
+    lw a1, 0(t0)
+    call sum                # a0 = 55
+    li t1, 55
+    bne a0, t1, fail
+
+    li t2, 0x12345FFF       # LUI + ADDI (하위 12비트가 음수)
+    li t3, 0x12345
+    slli t3, t3, 12
+    addi t3, t3, 0x7FF
+    addi t3, t3, 0x7FF
+    addi t3, t3, 1
+    bne t2, t3, fail
+
+    li t4, -1
+    not t5, t4
+    bnez t5, fail
+    neg t6, t4
+    seqz s0, zero
+    bne t6, s0, fail
+    snez s1, t4
+    ble s1, zero, fail
+    bgt zero, s1, fail
+    li s2, 0x80000000       # LUI만 사용
+    bgeu zero, s2, fail
+    bltz s1, fail
+    j done
+
+fail:
+    exit
+
+done:
+    nop
+    exit
+
+sum:                        # a0 = 배열 주소, a1 = 원소 개수
+    mv t0, zero
+loop:
+    beqz a1, sum_end
+    lw t1, 0(a0)
+    add t0, t0, t1
+    addi a0, a0, 4
+    addi a1, a1, -1
+    j loop
+sum_end:
+    mv a0, t0
+    ret
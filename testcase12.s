@@ -0,0 +1,62 @@
+# multi-hart 테스트 (--harts=N): hart i는 a0 = i, a1 = hart 개수로 시작함
+# hart 없이 실행하면 a1 = 0이므로 hart 하나로 봄
+# 각 hart가 array의 i, i + N, i + 2N, ... 번째 원소를 더해 partial[i]에 쓰고 done[i]를 1로 설정하면
+# hart 0이 모든 done을 기다린 뒤 partial을 합하여 total에 씀 (합이 360이 아니면 fail로 끝남)
+.data
+array:   .word 10, 20, 30, 40, 50, 60, 70, 80
+partial: .word 0, 0, 0, 0
+done:    .word 0, 0, 0, 0
+total:   .word 0
+
+.text
+main:
+    bnez a1, split
+    li a1, 1
+split:
+    la t0, array
+    slli t1, a0, 2
+    add t0, t0, t1          # t0 = &array[a0]
+    slli t2, a1, 2          # t2 = 원소 사이 간격
+    la t3, done             # t3 = 배열 끝
+    mv t4, zero
+sum_loop:
+    bgeu t0, t3, store
+    lw t5, 0(t0)
+    add t4, t4, t5
+    add t0, t0, t2
+    j sum_loop
+
+store:
+    la t0, partial
+    add t0, t0, t1
+    sw t4, 0(t0)
+    la t0, done
+    add t0, t0, t1
+    li t5, 1
+    sw t5, 0(t0)
+    bnez a0, finish
+
+    mv t6, zero             # hart 0: 모든 hart의 done과 partial을 확인
+    mv s0, zero
+    la s1, done
+    la s2, partial
+wait:
+    lw t5, 0(s1)
+    beqz t5, wait
+    lw t5, 0(s2)
+    add s0, s0, t5
+    addi s1, s1, 4
+    addi s2, s2, 4
+    addi t6, t6, 1
+    blt t6, a1, wait
+
+    la t0, total
+    sw s0, 0(t0)
+    li t1, 360
+    bne s0, t1, fail
+finish:
+    exit
+
+fail:
+    nop
+    exit
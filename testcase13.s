@@ -0,0 +1,45 @@
+# batch 실행 테스트 (--batch=testcase13.states): lane마다 a0, a1의 초기값이 다름
+# a0, a1의 하위 10비트의 최대공약수를 뺄셈으로 구하는 동안 lane이 서로 다른 분기로 갈라졌다가 다시 합쳐짐
+.data
+result: .word 0, 0
+
+.text
+main:
+    andi t0, a0, 0x3FF
+    andi t1, a1, 0x3FF
+    beqz t0, gcd_done
+    beqz t1, gcd_done
+gcd:
+    beq t0, t1, gcd_done
+    blt t0, t1, gcd_less
+    sub t0, t0, t1
+    j gcd
+gcd_less:
+    sub t1, t1, t0
+    j gcd
+gcd_done:
+    la t2, result
+    sw t0, 0(t2)
+
+    sll s0, a0, a1          # R/I type 연산을 모든 lane에서 함께 실행
+    srl s1, a0, a1
+    sra s2, a0, a1
+    slt s3, a0, a1
+    sltu s4, a0, a1
+    xor s5, a0, a1
+    or s6, a0, a1
+    and s7, a0, a1
+    add s8, a0, a1
+    sub s9, a0, a1
+    slti s10, a0, -5
+    sltiu s11, a0, 100
+    xori a2, a0, -1
+    ori a3, a1, 0x0F0
+    andi a4, a0, 0x7FF
+    slli a5, a1, 31
+    srli a6, a0, 28
+    srai a7, a0, 28
+    mul t3, a0, a1
+    lw t4, 0(t2)
+    sw s8, 4(t2)
+    exit
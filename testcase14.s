@@ -0,0 +1,16 @@
+# 최적화 회귀 테스트 (--optimize=run): 첫 블록이 아닌 블록에서도 x0는 상수 0이어야 함
+# A 블록의 x5 = 5와 다른 경로의 x5 = x1 + 6이 M에서 합쳐지므로 beq x5, x6, END는 항상 분기한다고 볼 수 없음
+main:
+    lw x7, 0(x0)
+    beq x7, x0, A
+    addi x5, x1, 6
+    j M
+A:
+    addi x5, x0, 5
+M:
+    addi x6, x1, 6
+    beq x5, x6, END
+    addi x10, x1, 0
+    exit
+END:
+    exit
@@ -0,0 +1,43 @@
+addi x7, x0, -7
+mul x8, x7, x3
+addi x9, x0, -21
+bne x8, x9, fail
+mulh x10, x7, x3
+addi x9, x0, -1
+bne x10, x9, fail
+mulhsu x11, x7, x3
+bne x11, x9, fail
+mulhu x12, x7, x3
+addi x9, x0, 2
+bne x12, x9, fail
+div x13, x7, x2
+addi x9, x0, -3
+bne x13, x9, fail
+rem x14, x7, x2
+addi x9, x0, -1
+bne x14, x9, fail
+divu x15, x7, x0
+bne x15, x9, fail
+remu x16, x7, x0
+bne x16, x7, fail
+divu x17, x7, x6
+remu x18, x7, x6
+mul x19, x17, x6
+add x19, x19, x18
+bne x19, x7, fail
+slli x20, x1, 31
+div x21, x20, x9
+bne x21, x20, fail
+rem x22, x20, x9
+bne x22, x0, fail
+addi x23, x0, 1
+addi x24, x0, 5
+loop:
+mul x23, x23, x24
+addi x24, x24, -1
+bne x24, x0, loop
+addi x9, x0, 120
+bne x23, x9, fail
+exit
+fail:
+exit